@@ -0,0 +1,191 @@
+// Deferred binary logging
+
+#ifndef ZWUTILS_IDF8266_BINLOG_H
+#define ZWUTILS_IDF8266_BINLOG_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <atomic>
+#include <type_traits>
+
+#include "esp_err.h"
+#include "esp_log.h"
+
+#include "FreeRTOS.h"
+#include "freertos/task.h"
+
+// A binary log record only captures the format string pointer and the raw
+// argument words; formatting and output are deferred to `BinLogDrain()`,
+// typically run from a low-priority task (see `BinLogStartDrainTask()`).
+//
+// Recording is not lock-free: this core has no atomic read-modify-write, so
+// each record is copied into the ring inside a critical section (interrupts
+// masked for a few dozen cycles). This is still much cheaper than formatting,
+// but do not treat `BinLogWrite()` as free in interrupt-latency-sensitive code.
+//
+// Restrictions, compared to `ESP_LOGx()`:
+// - Arguments must be integers or pointers no wider than a machine word.
+// - The format string, tag and `%s` arguments must have static storage
+//   duration (e.g. string literals), as they are only dereferenced when drained.
+//
+// Tunables (define before including):
+// - `ZW_BINLOG_BUFFER_RECORDS`: ring buffer capacity, power of 2 (default 32).
+// - `ZW_BINLOG_MAX_ARGS`: maximum number of arguments per record (default 4).
+//
+// Define `ZW_BINLOG_ENABLE` to route the error logging of the macros in
+// `ZW_IDFLTH.h` and `ZWMacros.h` here.
+
+#ifndef ZW_BINLOG_BUFFER_RECORDS
+#define ZW_BINLOG_BUFFER_RECORDS 32
+#endif
+
+#ifndef ZW_BINLOG_MAX_ARGS
+#define ZW_BINLOG_MAX_ARGS 4
+#endif
+
+namespace zw::esp8266::utils {
+
+struct BinLogRecord {
+  const char* tag;
+  const char* format;
+  uint32_t timestamp;  // `esp_log_timestamp()`, milliseconds
+  esp_log_level_t level;
+  uintptr_t args[ZW_BINLOG_MAX_ARGS];
+};
+
+namespace internal {
+
+static_assert((ZW_BINLOG_BUFFER_RECORDS & (ZW_BINLOG_BUFFER_RECORDS - 1)) == 0,
+              "ZW_BINLOG_BUFFER_RECORDS must be a power of 2");
+
+// Multiple producers, single consumer. This core has no atomic read-modify-write,
+// so producers claim a slot inside a (very short) critical section; the consumer
+// never blocks producers.
+struct BinLogRing {
+  std::atomic<uint32_t> head;  // Next slot to write
+  std::atomic<uint32_t> tail;  // Next slot to read
+  uint32_t overflow;
+  BinLogRecord records[ZW_BINLOG_BUFFER_RECORDS];
+};
+
+inline BinLogRing binlog_ring = {};
+
+template <typename T>
+uintptr_t BinLogArg(T arg) {
+  static_assert(std::is_integral_v<T> || std::is_enum_v<T> || std::is_pointer_v<T>,
+                "Only integer and pointer arguments are supported");
+  static_assert(sizeof(T) <= sizeof(uintptr_t), "Argument wider than a machine word");
+  if constexpr (std::is_pointer_v<T>) {
+    return (uintptr_t)arg;
+  } else {
+    return (uintptr_t)(intptr_t)arg;
+  }
+}
+
+}  // namespace internal
+
+template <typename... Args>
+void BinLogWrite(esp_log_level_t level, const char* tag, const char* format, Args... args) {
+  static_assert(sizeof...(Args) <= ZW_BINLOG_MAX_ARGS, "Too many arguments");
+  BinLogRecord record = {tag, format, esp_log_timestamp(), level,
+                         {internal::BinLogArg(args)...}};
+
+  internal::BinLogRing& ring = internal::binlog_ring;
+  taskENTER_CRITICAL();
+  uint32_t head = ring.head.load(std::memory_order_relaxed);
+  if (head - ring.tail.load(std::memory_order_acquire) < ZW_BINLOG_BUFFER_RECORDS) {
+    ring.records[head & (ZW_BINLOG_BUFFER_RECORDS - 1)] = record;
+    ring.head.store(head + 1, std::memory_order_release);
+  } else {
+    ++ring.overflow;
+  }
+  taskEXIT_CRITICAL();
+}
+
+// Number of records lost because the ring buffer was full.
+inline uint32_t BinLogOverflow() { return internal::binlog_ring.overflow; }
+
+// Retrieve the oldest record, returns false if there is none.
+// Must only be called from one task at a time.
+inline bool BinLogPop(BinLogRecord& record) {
+  internal::BinLogRing& ring = internal::binlog_ring;
+  uint32_t tail = ring.tail.load(std::memory_order_relaxed);
+  if (tail == ring.head.load(std::memory_order_acquire)) return false;
+  record = ring.records[tail & (ZW_BINLOG_BUFFER_RECORDS - 1)];
+  ring.tail.store(tail + 1, std::memory_order_release);
+  return true;
+}
+
+// Format the message of a record (without tag or timestamp), as `snprintf()`.
+inline int BinLogFormat(const BinLogRecord& record, char* out, size_t size) {
+  static_assert(ZW_BINLOG_MAX_ARGS == 4, "Update the argument list below");
+  const uintptr_t* args = record.args;
+  return snprintf(out, size, record.format, args[0], args[1], args[2], args[3]);
+}
+
+// Format and output up to `max_records` records through `ESP_LOGx()`,
+// returns the number of records drained.
+inline size_t BinLogDrain(size_t max_records = SIZE_MAX) {
+  static uint32_t reported_overflow = 0;
+  uint32_t overflow = BinLogOverflow();
+  if (overflow != reported_overflow) {
+    ESP_LOGW("BinLog", "%u record(s) lost", (unsigned)(overflow - reported_overflow));
+    reported_overflow = overflow;
+  }
+
+  size_t count = 0;
+  BinLogRecord record;
+  char message[128];
+  for (; count < max_records && BinLogPop(record); ++count) {
+    BinLogFormat(record, message, sizeof(message));
+    switch (record.level) {
+      case ESP_LOG_ERROR:
+        ESP_LOGE(record.tag, "[@%u] %s", (unsigned)record.timestamp, message);
+        break;
+      case ESP_LOG_WARN:
+        ESP_LOGW(record.tag, "[@%u] %s", (unsigned)record.timestamp, message);
+        break;
+      case ESP_LOG_INFO:
+        ESP_LOGI(record.tag, "[@%u] %s", (unsigned)record.timestamp, message);
+        break;
+      case ESP_LOG_DEBUG:
+        ESP_LOGD(record.tag, "[@%u] %s", (unsigned)record.timestamp, message);
+        break;
+      default:
+        ESP_LOGV(record.tag, "[@%u] %s", (unsigned)record.timestamp, message);
+    }
+  }
+  return count;
+}
+
+// Start a task that periodically drains the binary log.
+inline esp_err_t BinLogStartDrainTask(TickType_t period = pdMS_TO_TICKS(100),
+                                      UBaseType_t priority = tskIDLE_PRIORITY + 1,
+                                      uint32_t stack_size = 2048) {
+  auto drain_task = [](void* param) {
+    while (true) {
+      BinLogDrain();
+      vTaskDelay((TickType_t)(uintptr_t)param);
+    }
+  };
+  if (xTaskCreate(drain_task, "binlog", stack_size, (void*)(uintptr_t)period, priority,
+                  nullptr) != pdPASS)
+    return ESP_ERR_NO_MEM;
+  return ESP_OK;
+}
+
+}  // namespace zw::esp8266::utils
+
+// Record a binary log message, subject to `LOG_LOCAL_LEVEL`.
+#define ZW_BINLOG(level, tag, format, ...)                                  \
+  do {                                                                      \
+    if (LOG_LOCAL_LEVEL >= (level))                                         \
+      ::zw::esp8266::utils::BinLogWrite(level, tag, format, ##__VA_ARGS__); \
+  } while (0)
+
+#define ZW_BINLOGE(tag, format, ...) ZW_BINLOG(ESP_LOG_ERROR, tag, format, ##__VA_ARGS__)
+#define ZW_BINLOGW(tag, format, ...) ZW_BINLOG(ESP_LOG_WARN, tag, format, ##__VA_ARGS__)
+#define ZW_BINLOGI(tag, format, ...) ZW_BINLOG(ESP_LOG_INFO, tag, format, ##__VA_ARGS__)
+#define ZW_BINLOGD(tag, format, ...) ZW_BINLOG(ESP_LOG_DEBUG, tag, format, ##__VA_ARGS__)
+
+#endif  // ZWUTILS_IDF8266_BINLOG_H
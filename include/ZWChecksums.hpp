@@ -0,0 +1,170 @@
+// Checksum and non-cryptographic hash utilities
+
+#ifndef ZWUTILS_IDF8266_CHECKSUMS_H
+#define ZWUTILS_IDF8266_CHECKSUMS_H
+
+#include <stdint.h>
+#include <string.h>
+#include <array>
+#include <string_view>
+
+#include "ZWDataBuf.hpp"
+
+// Define `ZW_CRC32_COMPACT_TABLE` to trade CRC32 throughput for flash space:
+// the default slicing-by-8 tables take 8KB, the compact (nibble) table 64 bytes.
+
+namespace zw::esp8266::utils {
+
+namespace internal {
+
+inline constexpr uint32_t kCrc32Poly = 0xEDB88320;  // Reflected IEEE 802.3
+
+#ifdef ZW_CRC32_COMPACT_TABLE
+
+constexpr std::array<uint32_t, 16> MakeCrc32NibbleTable() {
+  std::array<uint32_t, 16> table{};
+  for (uint32_t i = 0; i < 16; ++i) {
+    uint32_t crc = i;
+    for (int k = 0; k < 4; ++k) crc = (crc >> 1) ^ (kCrc32Poly & (0 - (crc & 1)));
+    table[i] = crc;
+  }
+  return table;
+}
+
+inline constexpr auto kCrc32Table = MakeCrc32NibbleTable();
+
+inline uint32_t Crc32Update(uint32_t crc, const uint8_t* data, size_t len) {
+  for (const uint8_t* end = data + len; data < end; ++data) {
+    crc ^= *data;
+    crc = (crc >> 4) ^ kCrc32Table[crc & 0xF];
+    crc = (crc >> 4) ^ kCrc32Table[crc & 0xF];
+  }
+  return crc;
+}
+
+#else
+
+static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__, "Slicing-by-8 assumes little-endian");
+
+using Crc32Tables = std::array<std::array<uint32_t, 256>, 8>;
+
+constexpr Crc32Tables MakeCrc32SlicingTables() {
+  Crc32Tables tables{};
+  for (uint32_t i = 0; i < 256; ++i) {
+    uint32_t crc = i;
+    for (int k = 0; k < 8; ++k) crc = (crc >> 1) ^ (kCrc32Poly & (0 - (crc & 1)));
+    tables[0][i] = crc;
+  }
+  for (size_t t = 1; t < 8; ++t) {
+    for (size_t i = 0; i < 256; ++i) {
+      uint32_t prev = tables[t - 1][i];
+      tables[t][i] = (prev >> 8) ^ tables[0][prev & 0xFF];
+    }
+  }
+  return tables;
+}
+
+inline constexpr Crc32Tables kCrc32Tables = MakeCrc32SlicingTables();
+
+inline uint32_t Crc32Update(uint32_t crc, const uint8_t* data, size_t len) {
+  const auto& t = kCrc32Tables;
+  auto update_byte = [&](uint8_t b) { crc = t[0][(crc ^ b) & 0xFF] ^ (crc >> 8); };
+
+  // Align to word boundary, the core faults on unaligned word access
+  for (; len && ((uintptr_t)data & 3); --len) update_byte(*data++);
+  for (; len >= 8; len -= 8, data += 8) {
+    uint32_t lo, hi;
+    memcpy(&lo, __builtin_assume_aligned(data, 4), 4);
+    memcpy(&hi, __builtin_assume_aligned(data + 4, 4), 4);
+    lo ^= crc;
+    crc = t[7][lo & 0xFF] ^ t[6][(lo >> 8) & 0xFF] ^ t[5][(lo >> 16) & 0xFF] ^ t[4][lo >> 24] ^
+          t[3][hi & 0xFF] ^ t[2][(hi >> 8) & 0xFF] ^ t[1][(hi >> 16) & 0xFF] ^ t[0][hi >> 24];
+  }
+  for (; len; --len) update_byte(*data++);
+  return crc;
+}
+
+#endif  // ZW_CRC32_COMPACT_TABLE
+
+constexpr uint32_t RotL32(uint32_t x, int r) { return (x << r) | (x >> (32 - r)); }
+
+constexpr uint32_t ReadLE32(std::string_view data, size_t pos) {
+  return (uint32_t)(uint8_t)data[pos] | ((uint32_t)(uint8_t)data[pos + 1] << 8) |
+         ((uint32_t)(uint8_t)data[pos + 2] << 16) | ((uint32_t)(uint8_t)data[pos + 3] << 24);
+}
+
+}  // namespace internal
+
+// CRC-32 (IEEE 802.3, as used by zlib, PNG, etc.), supporting incremental updates.
+//   Crc32 crc;
+//   crc.Update(chunk1, len1).Update(chunk2, len2);
+//   uint32_t result = crc.value();
+class Crc32 {
+ public:
+  Crc32& Update(const void* data, size_t len) {
+    state_ = internal::Crc32Update(state_, (const uint8_t*)data, len);
+    return *this;
+  }
+  Crc32& Update(const DataBuf& buf) { return Update(buf.data(), buf.size()); }
+
+  uint32_t value() const { return ~state_; }
+  void Reset() { state_ = ~0U; }
+
+  static uint32_t Compute(const void* data, size_t len) {
+    return Crc32().Update(data, len).value();
+  }
+  static uint32_t Compute(const DataBuf& buf) { return Compute(buf.data(), buf.size()); }
+
+ private:
+  uint32_t state_ = ~0U;
+};
+
+// 32-bit FNV-1a, simple and compact, best for short keys.
+constexpr uint32_t Fnv1a32(std::string_view data, uint32_t hash = 0x811C9DC5) {
+  for (char c : data) hash = (hash ^ (uint8_t)c) * 0x01000193;
+  return hash;
+}
+
+// 32-bit xxHash, processes 16 bytes per round, best for larger inputs.
+// Reads are byte-wise, so any alignment is supported, and it is usable
+// at compile-time for constant keys.
+constexpr uint32_t XXHash32(std::string_view data, uint32_t seed = 0) {
+  constexpr uint32_t P1 = 0x9E3779B1, P2 = 0x85EBCA77, P3 = 0xC2B2AE3D, P4 = 0x27D4EB2F,
+                     P5 = 0x165667B1;
+  using internal::ReadLE32;
+  using internal::RotL32;
+
+  const size_t len = data.size();
+  size_t pos = 0;
+  uint32_t hash = seed + P5;
+  if (len >= 16) {
+    uint32_t v1 = seed + P1 + P2, v2 = seed + P2, v3 = seed, v4 = seed - P1;
+    for (; pos + 16 <= len; pos += 16) {
+      v1 = RotL32(v1 + ReadLE32(data, pos) * P2, 13) * P1;
+      v2 = RotL32(v2 + ReadLE32(data, pos + 4) * P2, 13) * P1;
+      v3 = RotL32(v3 + ReadLE32(data, pos + 8) * P2, 13) * P1;
+      v4 = RotL32(v4 + ReadLE32(data, pos + 12) * P2, 13) * P1;
+    }
+    hash = RotL32(v1, 1) + RotL32(v2, 7) + RotL32(v3, 12) + RotL32(v4, 18);
+  }
+
+  hash += (uint32_t)len;
+  for (; pos + 4 <= len; pos += 4) hash = RotL32(hash + ReadLE32(data, pos) * P3, 17) * P4;
+  for (; pos < len; ++pos) hash = RotL32(hash + (uint8_t)data[pos] * P5, 11) * P1;
+
+  hash = (hash ^ (hash >> 15)) * P2;
+  hash = (hash ^ (hash >> 13)) * P3;
+  return hash ^ (hash >> 16);
+}
+
+// Raw buffer variant, named apart so `XXHash32("abc", seed)` cannot pick it.
+inline uint32_t XXHash32Bytes(const void* data, size_t len, uint32_t seed = 0) {
+  return XXHash32({(const char*)data, len}, seed);
+}
+inline uint32_t XXHash32(const DataBuf& buf, uint32_t seed = 0) {
+  return XXHash32Bytes(buf.data(), buf.size(), seed);
+}
+
+}  // namespace zw::esp8266::utils
+
+#endif  // ZWUTILS_IDF8266_CHECKSUMS_H
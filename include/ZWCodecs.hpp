@@ -0,0 +1,354 @@
+// Table-driven Base64 and hex encoding / decoding
+
+#ifndef ZWUTILS_IDF8266_CODECS_H
+#define ZWUTILS_IDF8266_CODECS_H
+
+#include <stdint.h>
+#include <string.h>
+#include <array>
+#include <string_view>
+
+#include "esp_err.h"
+
+#include "ZWDataOrError.hpp"
+#include "ZWDataBuf.hpp"
+#include "ZWParsers.hpp"
+
+namespace zw::esp8266::utils {
+
+// The pointer-based functions write into [out, out + out_size), and return
+// the exact number of bytes written, or ESP_ERR_INVALID_SIZE if the output
+// does not fit. Decoders return ESP_ERR_INVALID_ARG on malformed input,
+// in which case the output content is unspecified.
+//
+// Decoders support in-place operation (i.e. `out` == `in.data()`),
+// encoders require non-overlapping input and output.
+
+enum class Base64Alphabet : uint8_t {
+  kStandard,  // RFC 4648 section 4, "+/"
+  kUrlSafe,   // RFC 4648 section 5, "-_"
+};
+
+constexpr size_t HexEncodedSize(size_t len) { return len * 2; }
+constexpr size_t HexDecodedSize(size_t len) { return len / 2; }
+
+constexpr size_t Base64EncodedSize(size_t len, bool pad = true) {
+  return pad ? (len + 2) / 3 * 4 : len / 3 * 4 + (len % 3 ? len % 3 + 1 : 0);
+}
+
+// Exact decoded size of (well-formed) input, with or without padding.
+inline size_t Base64DecodedSize(std::string_view in) {
+  size_t len = in.size();
+  if (len && in[len - 1] == '=') --len;
+  if (len && in[len - 1] == '=') --len;
+  return len / 4 * 3 + (len % 4 ? len % 4 - 1 : 0);
+}
+
+namespace internal {
+
+inline constexpr uint8_t kInvalidCode = 0xFF;
+
+inline constexpr char kBase64Std[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+inline constexpr char kBase64Url[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+
+constexpr std::array<uint8_t, 256> MakeDecodeTable(const char* alphabet, size_t len) {
+  std::array<uint8_t, 256> table{};
+  for (auto& entry : table) entry = kInvalidCode;
+  for (size_t i = 0; i < len; ++i) table[(uint8_t)alphabet[i]] = i;
+  return table;
+}
+
+constexpr std::array<char, 512> MakeHexEncodeTable(const char* digits) {
+  std::array<char, 512> table{};
+  for (size_t i = 0; i < 256; ++i) {
+    table[i * 2] = digits[i >> 4];
+    table[i * 2 + 1] = digits[i & 0xF];
+  }
+  return table;
+}
+
+inline constexpr auto kBase64StdDecode = MakeDecodeTable(kBase64Std, 64);
+inline constexpr auto kBase64UrlDecode = MakeDecodeTable(kBase64Url, 64);
+inline constexpr auto kHexEncodeLower = MakeHexEncodeTable("0123456789abcdef");
+inline constexpr auto kHexEncodeUpper = MakeHexEncodeTable("0123456789ABCDEF");
+
+inline const char* Base64EncodeTable(Base64Alphabet alphabet) {
+  return alphabet == Base64Alphabet::kUrlSafe ? kBase64Url : kBase64Std;
+}
+
+inline const uint8_t* Base64DecodeTable(Base64Alphabet alphabet) {
+  return alphabet == Base64Alphabet::kUrlSafe ? kBase64UrlDecode.data() : kBase64StdDecode.data();
+}
+
+// Decodes up to `quads` groups of 4 characters, and stops at the first
+// group containing a non-alphabet character. Returns the groups decoded.
+inline size_t Base64DecodeQuads(const uint8_t* in, size_t quads, uint8_t* out,
+                                const uint8_t* table) {
+  for (size_t i = 0; i < quads; ++i, in += 4, out += 3) {
+    uint32_t a = table[in[0]], b = table[in[1]], c = table[in[2]], d = table[in[3]];
+    if ((a | b | c | d) & 0x80) return i;
+    uint32_t word = (a << 18) | (b << 12) | (c << 6) | d;
+    out[0] = word >> 16;
+    out[1] = word >> 8;
+    out[2] = word;
+  }
+  return quads;
+}
+
+// Decodes a trailing partial group of 2 or 3 (valid) 6-bit codes.
+inline uint8_t* Base64DecodeTail(const uint8_t* codes, size_t len, uint8_t* out) {
+  *out++ = (codes[0] << 2) | (codes[1] >> 4);
+  if (len > 2) *out++ = (codes[1] << 4) | (codes[2] >> 2);
+  return out;
+}
+
+}  // namespace internal
+
+//---------------------------
+// Hex
+//---------------------------
+
+inline DataOrError<size_t> HexEncode(const uint8_t* in, size_t len, char* out, size_t out_size,
+                                     bool upper = false) {
+  const size_t out_len = HexEncodedSize(len);
+  if (out_len > out_size) return ESP_ERR_INVALID_SIZE;
+
+  const char* table = upper ? internal::kHexEncodeUpper.data() : internal::kHexEncodeLower.data();
+  for (const uint8_t* end = in + len; in < end; ++in, out += 2) memcpy(out, &table[*in * 2], 2);
+  return out_len;
+}
+
+// Input may be in either letter case.
+inline DataOrError<size_t> HexDecode(std::string_view in, uint8_t* out, size_t out_size) {
+  if (in.size() % 2) return ESP_ERR_INVALID_ARG;
+  const size_t out_len = HexDecodedSize(in.size());
+  if (out_len > out_size) return ESP_ERR_INVALID_SIZE;
+
+  const uint8_t* table = internal::kHexDecode.data();  // Shared with `ParseHex()`
+  const uint8_t* in_ptr = (const uint8_t*)in.data();
+  // Accumulate invalid markers and check once at the end
+  uint8_t invalid = 0;
+  for (size_t i = 0; i < out_len; ++i, in_ptr += 2) {
+    uint8_t h = table[in_ptr[0]], l = table[in_ptr[1]];
+    invalid |= h | l;
+    out[i] = (h << 4) | l;
+  }
+  if (invalid & 0x80) return ESP_ERR_INVALID_ARG;
+  return out_len;
+}
+
+// Appends the hex encoded text to `out`.
+inline void HexEncode(const uint8_t* in, size_t len, DataBuf& out, bool upper = false) {
+  size_t old_size = out.size();
+  out.resize(old_size + HexEncodedSize(len));
+  HexEncode(in, len, (char*)out.data() + old_size, out.size() - old_size, upper);
+}
+
+// Appends the decoded data to `out`.
+inline esp_err_t HexDecode(std::string_view in, DataBuf& out) {
+  size_t old_size = out.size();
+  out.resize(old_size + HexDecodedSize(in.size()));
+  DataOrError<size_t> result = HexDecode(in, out.data() + old_size, out.size() - old_size);
+  if (!result) out.resize(old_size);
+  return result.error();
+}
+
+inline esp_err_t HexDecodeInPlace(DataBuf& buf) {
+  DataOrError<size_t> result =
+      HexDecode({(const char*)buf.data(), buf.size()}, buf.data(), buf.size());
+  if (result) buf.resize(*result);
+  return result.error();
+}
+
+//---------------------------
+// Base64
+//---------------------------
+
+inline DataOrError<size_t> Base64Encode(const uint8_t* in, size_t len, char* out, size_t out_size,
+                                        Base64Alphabet alphabet = Base64Alphabet::kStandard,
+                                        bool pad = true) {
+  const size_t out_len = Base64EncodedSize(len, pad);
+  if (out_len > out_size) return ESP_ERR_INVALID_SIZE;
+
+  const char* table = internal::Base64EncodeTable(alphabet);
+  for (; len >= 3; len -= 3, in += 3, out += 4) {
+    uint32_t word = (in[0] << 16) | (in[1] << 8) | in[2];
+    out[0] = table[word >> 18];
+    out[1] = table[(word >> 12) & 0x3F];
+    out[2] = table[(word >> 6) & 0x3F];
+    out[3] = table[word & 0x3F];
+  }
+  if (len) {
+    uint32_t word = (in[0] << 16) | (len > 1 ? in[1] << 8 : 0);
+    *out++ = table[word >> 18];
+    *out++ = table[(word >> 12) & 0x3F];
+    if (len > 1) {
+      *out++ = table[(word >> 6) & 0x3F];
+    } else if (pad) {
+      *out++ = '=';
+    }
+    if (pad) *out++ = '=';
+  }
+  return out_len;
+}
+
+// Accepts input with or without padding.
+inline DataOrError<size_t> Base64Decode(std::string_view in, uint8_t* out, size_t out_size,
+                                        Base64Alphabet alphabet = Base64Alphabet::kStandard) {
+  size_t len = in.size();
+  if (len && in[len - 1] == '=') --len;
+  if (len && in[len - 1] == '=') --len;
+  if ((len != in.size() && in.size() % 4) || len % 4 == 1) return ESP_ERR_INVALID_ARG;
+  const size_t out_len = Base64DecodedSize(in);
+  if (out_len > out_size) return ESP_ERR_INVALID_SIZE;
+
+  const uint8_t* table = internal::Base64DecodeTable(alphabet);
+  const uint8_t* in_ptr = (const uint8_t*)in.data();
+  const size_t quads = len / 4;
+  if (internal::Base64DecodeQuads(in_ptr, quads, out, table) != quads) return ESP_ERR_INVALID_ARG;
+
+  if (size_t tail_len = len % 4) {
+    uint8_t codes[3];
+    for (size_t i = 0; i < tail_len; ++i) {
+      if ((codes[i] = table[in_ptr[quads * 4 + i]]) & 0x80) return ESP_ERR_INVALID_ARG;
+    }
+    internal::Base64DecodeTail(codes, tail_len, out + quads * 3);
+  }
+  return out_len;
+}
+
+// Appends the Base64 encoded text to `out`.
+inline void Base64Encode(const uint8_t* in, size_t len, DataBuf& out,
+                         Base64Alphabet alphabet = Base64Alphabet::kStandard, bool pad = true) {
+  size_t old_size = out.size();
+  out.resize(old_size + Base64EncodedSize(len, pad));
+  Base64Encode(in, len, (char*)out.data() + old_size, out.size() - old_size, alphabet, pad);
+}
+
+// Appends the decoded data to `out`.
+inline esp_err_t Base64Decode(std::string_view in, DataBuf& out,
+                              Base64Alphabet alphabet = Base64Alphabet::kStandard) {
+  size_t old_size = out.size();
+  out.resize(old_size + Base64DecodedSize(in));
+  DataOrError<size_t> result =
+      Base64Decode(in, out.data() + old_size, out.size() - old_size, alphabet);
+  if (!result) out.resize(old_size);
+  return result.error();
+}
+
+inline esp_err_t Base64DecodeInPlace(DataBuf& buf,
+                                     Base64Alphabet alphabet = Base64Alphabet::kStandard) {
+  DataOrError<size_t> result =
+      Base64Decode({(const char*)buf.data(), buf.size()}, buf.data(), buf.size(), alphabet);
+  if (result) buf.resize(*result);
+  return result.error();
+}
+
+// Streaming encoder, for input arriving in arbitrarily sized chunks.
+class Base64Encoder {
+ public:
+  explicit Base64Encoder(Base64Alphabet alphabet = Base64Alphabet::kStandard, bool pad = true)
+      : alphabet_(alphabet), pad_(pad) {}
+
+  // Appends the encoded text of all complete 3-byte groups to `out`.
+  void Update(const uint8_t* in, size_t len, DataBuf& out) {
+    if (carry_len_) {
+      for (; carry_len_ < 3 && len; --len) carry_[carry_len_++] = *in++;
+      if (carry_len_ < 3) return;
+      Base64Encode(carry_, 3, out, alphabet_);
+      carry_len_ = 0;
+    }
+    size_t bulk_len = len / 3 * 3;
+    Base64Encode(in, bulk_len, out, alphabet_);
+    for (in += bulk_len, len -= bulk_len; len; --len) carry_[carry_len_++] = *in++;
+  }
+
+  // Appends the remaining encoded text, and resets the encoder.
+  void Finish(DataBuf& out) {
+    Base64Encode(carry_, carry_len_, out, alphabet_, pad_);
+    carry_len_ = 0;
+  }
+
+ private:
+  const Base64Alphabet alphabet_;
+  const bool pad_;
+  uint8_t carry_[3];
+  uint8_t carry_len_ = 0;
+};
+
+// Streaming decoder, for input arriving in arbitrarily sized chunks.
+// Whitespace (e.g. line breaks in PEM data) is skipped.
+class Base64Decoder {
+ public:
+  explicit Base64Decoder(Base64Alphabet alphabet = Base64Alphabet::kStandard)
+      : table_(internal::Base64DecodeTable(alphabet)) {}
+
+  // Appends the decoded data of all complete 4-character groups to `out`.
+  esp_err_t Update(std::string_view in, DataBuf& out) {
+    size_t old_size = out.size();
+    out.resize(old_size + (in.size() + codes_len_) / 4 * 3);
+    uint8_t* out_ptr = out.data() + old_size;
+    const uint8_t* in_ptr = (const uint8_t*)in.data();
+    const uint8_t* in_end = in_ptr + in.size();
+
+    esp_err_t result = ESP_OK;
+    while (in_ptr < in_end) {
+      if (codes_len_ == 0 && padding_ == 0) {
+        // Fast path, until a group containing non-alphabet character
+        size_t quads = (in_end - in_ptr) / 4;
+        size_t decoded = internal::Base64DecodeQuads(in_ptr, quads, out_ptr, table_);
+        in_ptr += decoded * 4;
+        out_ptr += decoded * 3;
+        if (in_ptr >= in_end) break;
+      }
+
+      uint8_t c = *in_ptr++;
+      if (c == ' ' || c == '\t' || c == '\r' || c == '\n') continue;
+      // Up to 2 padding characters complete the group, nothing may follow
+      if (c == '=' && codes_len_ >= 2 && codes_len_ + padding_ < 4) {
+        ++padding_;
+        continue;
+      }
+      uint8_t code = table_[c];
+      if ((code & 0x80) || padding_) {
+        result = ESP_ERR_INVALID_ARG;
+        break;
+      }
+      codes_[codes_len_++] = code;
+      if (codes_len_ == 4) {
+        out_ptr = internal::Base64DecodeTail(codes_, 3, out_ptr);
+        *out_ptr++ = (codes_[2] << 6) | codes_[3];
+        codes_len_ = 0;
+      }
+    }
+    out.resize(out_ptr - out.data());
+    return result;
+  }
+
+  // Appends the remaining decoded data, and resets the decoder.
+  esp_err_t Finish(DataBuf& out) {
+    esp_err_t result = ESP_OK;
+    if (codes_len_ == 1) {
+      result = ESP_ERR_INVALID_ARG;
+    } else if (codes_len_) {
+      size_t old_size = out.size();
+      out.resize(old_size + codes_len_ - 1);
+      internal::Base64DecodeTail(codes_, codes_len_, out.data() + old_size);
+    }
+    codes_len_ = 0;
+    padding_ = 0;
+    return result;
+  }
+
+ private:
+  const uint8_t* const table_;
+  uint8_t codes_[4];
+  uint8_t codes_len_ = 0;
+  uint8_t padding_ = 0;
+};
+
+}  // namespace zw::esp8266::utils
+
+#endif  // ZWUTILS_IDF8266_CODECS_H
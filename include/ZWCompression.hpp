@@ -0,0 +1,241 @@
+// Streaming LZSS compression
+
+#ifndef ZWUTILS_IDF8266_COMPRESSION_H
+#define ZWUTILS_IDF8266_COMPRESSION_H
+
+#include <stdint.h>
+#include <string.h>
+#include <algorithm>
+#include <memory>
+
+#include "esp_err.h"
+
+#include "ZWDataBuf.hpp"
+
+namespace zw::esp8266::utils {
+
+// A heatshrink-style LZSS bitstream (MSB first): each item is either
+//   1 + 8-bit literal, or
+//   0 + `WindowBits` (distance - 1) + `LookaheadBits` (length - kMinMatch).
+// The stream ends with up to 7 zero padding bits, there is no header; the
+// decoder must use the same parameters as the encoder.
+//
+// Memory is fixed at compile-time, see `sizeof()` of the encoder and decoder
+// (e.g. ~8KB / ~1KB for the default 1KB window), so they are best allocated
+// statically or on the heap, not on a task stack.
+
+namespace internal {
+
+template <unsigned WindowBits, unsigned LookaheadBits>
+struct LzParams {
+  static_assert(WindowBits >= 6 && WindowBits <= 14, "Window bits out of range");
+  static_assert(LookaheadBits >= 2 && LookaheadBits <= 8 && LookaheadBits < WindowBits,
+                "Lookahead bits out of range");
+
+  static constexpr size_t kWindow = 1 << WindowBits;
+  // Shortest match that is cheaper than literals
+  static constexpr size_t kMinMatch = (1 + WindowBits + LookaheadBits) / 9 + 1;
+  static constexpr size_t kMaxMatch = kMinMatch + (1 << LookaheadBits) - 1;
+};
+
+}  // namespace internal
+
+// Streaming encoder, for input arriving in arbitrarily sized chunks.
+// The output does not depend on how the input is chunked.
+// `MaxChain` bounds the match candidates examined per position, trading
+// compression ratio for speed.
+template <unsigned WindowBits = 10, unsigned LookaheadBits = 4, unsigned MaxChain = 16>
+class LzEncoder {
+  using Params = internal::LzParams<WindowBits, LookaheadBits>;
+  static constexpr size_t kWindow = Params::kWindow;
+  static constexpr size_t kBufSize = kWindow * 2;
+  static constexpr unsigned kHashBits = WindowBits;
+  static constexpr uint16_t kNil = UINT16_MAX;
+
+ public:
+  LzEncoder() { Reset(); }
+
+  // Appends the compressed data of the input that can be processed so far.
+  void Update(const uint8_t* in, size_t len, DataBuf& out) {
+    while (len) {
+      size_t count = std::min(len, kBufSize - fill_);
+      memcpy(buf_ + fill_, in, count);
+      fill_ += count;
+      in += count;
+      len -= count;
+      if (fill_ == kBufSize) {
+        Compress_(fill_ - Params::kMaxMatch, out);
+        Slide_();
+      }
+    }
+  }
+  void Update(const DataBuf& in, DataBuf& out) { Update(in.data(), in.size(), out); }
+
+  // Appends the remaining compressed data, and resets the encoder.
+  void Finish(DataBuf& out) {
+    Compress_(fill_, out);
+    if (bits_) out.push_back((uint8_t)(acc_ << (8 - bits_)));
+    Reset();
+  }
+
+  void Reset() {
+    fill_ = pos_ = 0;
+    acc_ = bits_ = 0;
+    std::fill(std::begin(head_), std::end(head_), kNil);
+  }
+
+ private:
+  uint8_t buf_[kBufSize];          // [Window history | lookahead]
+  uint16_t head_[1 << kHashBits];  // Most recent position of each hash
+  uint16_t prev_[kBufSize];        // Previous position with the same hash
+  size_t fill_;
+  size_t pos_;
+  uint32_t acc_;
+  unsigned bits_;
+
+  static size_t Hash_(const uint8_t* data) {
+    return ((uint32_t)(data[0] << 8 | data[1]) * 0x9E3779B1U) >> (32 - kHashBits);
+  }
+
+  void Insert_(size_t pos) {
+    if (pos + 1 >= fill_) return;
+    uint16_t& head = head_[Hash_(buf_ + pos)];
+    prev_[pos] = head;
+    head = pos;
+  }
+
+  void WriteBits_(uint32_t value, unsigned count, DataBuf& out) {
+    acc_ = (acc_ << count) | value;
+    for (bits_ += count; bits_ >= 8; bits_ -= 8) out.push_back((uint8_t)(acc_ >> (bits_ - 8)));
+  }
+
+  // Encode positions up to `limit`, matches may extend up to `fill_`.
+  void Compress_(size_t limit, DataBuf& out) {
+    out.reserve(out.size() + (limit - std::min(pos_, limit)) * 9 / 8 + 1);
+    while (pos_ < limit) {
+      const size_t max_len = std::min(Params::kMaxMatch, fill_ - pos_);
+      size_t best_len = 0, best_dist = 0;
+      if (max_len >= Params::kMinMatch) {
+        uint16_t candidate = head_[Hash_(buf_ + pos_)];
+        for (unsigned chain = 0; chain < MaxChain && candidate != kNil; ++chain) {
+          size_t dist = pos_ - candidate;
+          if (dist > kWindow) break;
+          if (buf_[candidate + best_len] == buf_[pos_ + best_len]) {
+            size_t len = 0;
+            while (len < max_len && buf_[candidate + len] == buf_[pos_ + len]) ++len;
+            if (len > best_len) {
+              best_len = len;
+              best_dist = dist;
+              if (len == max_len) break;
+            }
+          }
+          candidate = prev_[candidate];
+        }
+      }
+
+      if (best_len >= Params::kMinMatch) {
+        WriteBits_(0, 1, out);
+        WriteBits_(best_dist - 1, WindowBits, out);
+        WriteBits_(best_len - Params::kMinMatch, LookaheadBits, out);
+        for (size_t end = pos_ + best_len; pos_ < end; ++pos_) Insert_(pos_);
+      } else {
+        WriteBits_(0x100 | buf_[pos_], 9, out);
+        Insert_(pos_++);
+      }
+    }
+  }
+
+  // Discard data beyond the window, to make room for more input.
+  void Slide_() {
+    size_t shift = pos_ - kWindow;
+    memmove(buf_, buf_ + shift, fill_ - shift);
+    memmove(prev_, prev_ + shift, (fill_ - shift) * sizeof(prev_[0]));
+    auto rebase = [shift](uint16_t& p) { p = (p != kNil && p >= shift) ? p - shift : kNil; };
+    std::for_each(std::begin(head_), std::end(head_), rebase);
+    std::for_each(prev_, prev_ + fill_ - shift, rebase);
+    fill_ -= shift;
+    pos_ -= shift;
+  }
+};
+
+// Streaming decoder, for input arriving in arbitrarily sized chunks.
+template <unsigned WindowBits = 10, unsigned LookaheadBits = 4>
+class LzDecoder {
+  using Params = internal::LzParams<WindowBits, LookaheadBits>;
+  static constexpr size_t kWindow = Params::kWindow;
+
+ public:
+  // Appends the decompressed data of all complete items to `out`.
+  // Returns ESP_ERR_INVALID_ARG if the data is corrupted.
+  esp_err_t Update(const uint8_t* in, size_t len, DataBuf& out) {
+    // Grow geometrically, so decoding in small chunks stays linear
+    size_t expected = out.size() + len * 2;
+    if (expected > out.capacity()) out.reserve(std::max(expected, out.capacity() * 2));
+    for (const uint8_t* end = in + len; in < end; ++in) {
+      acc_ = (acc_ << 8) | *in;
+      bits_ += 8;
+      while (bits_ >= 9) {
+        if ((acc_ >> (bits_ - 1)) & 1) {
+          Emit_((uint8_t)(acc_ >> (bits_ - 9)), out);
+          bits_ -= 9;
+          continue;
+        }
+        if (bits_ < 1 + WindowBits + LookaheadBits) break;
+        bits_ -= 1 + WindowBits;
+        size_t dist = ((acc_ >> bits_) & (kWindow - 1)) + 1;
+        bits_ -= LookaheadBits;
+        size_t len = ((acc_ >> bits_) & ((1 << LookaheadBits) - 1)) + Params::kMinMatch;
+        if (dist > produced_) return ESP_ERR_INVALID_ARG;
+        for (; len; --len) Emit_(window_[(pos_ - dist) & (kWindow - 1)], out);
+      }
+    }
+    return ESP_OK;
+  }
+  esp_err_t Update(const DataBuf& in, DataBuf& out) { return Update(in.data(), in.size(), out); }
+
+  // Checks the stream ended cleanly, and resets the decoder.
+  // Returns ESP_ERR_INVALID_SIZE if the data is truncated.
+  esp_err_t Finish() {
+    bool clean = bits_ < 8 && (acc_ & ((1 << bits_) - 1)) == 0;
+    Reset();
+    return clean ? ESP_OK : ESP_ERR_INVALID_SIZE;
+  }
+
+  void Reset() {
+    acc_ = bits_ = 0;
+    pos_ = produced_ = 0;
+  }
+
+ private:
+  uint8_t window_[kWindow];
+  size_t pos_ = 0;
+  size_t produced_ = 0;  // Saturates at the window size
+  uint32_t acc_ = 0;
+  unsigned bits_ = 0;
+
+  void Emit_(uint8_t c, DataBuf& out) {
+    out.push_back(c);
+    window_[pos_++ & (kWindow - 1)] = c;
+    if (produced_ < kWindow) ++produced_;
+  }
+};
+
+// One-shot helpers, allocating the codec state on the heap.
+template <unsigned WindowBits = 10, unsigned LookaheadBits = 4>
+void LzCompress(const uint8_t* in, size_t len, DataBuf& out) {
+  auto encoder = std::make_unique<LzEncoder<WindowBits, LookaheadBits>>();
+  encoder->Update(in, len, out);
+  encoder->Finish(out);
+}
+
+template <unsigned WindowBits = 10, unsigned LookaheadBits = 4>
+esp_err_t LzDecompress(const uint8_t* in, size_t len, DataBuf& out) {
+  auto decoder = std::make_unique<LzDecoder<WindowBits, LookaheadBits>>();
+  esp_err_t result = decoder->Update(in, len, out);
+  if (result != ESP_OK) return result;
+  return decoder->Finish();
+}
+
+}  // namespace zw::esp8266::utils
+
+#endif  // ZWUTILS_IDF8266_COMPRESSION_H
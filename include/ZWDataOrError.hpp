@@ -5,6 +5,7 @@
 
 #include <variant>
 #include <utility>
+#include <type_traits>
 
 #include "ZWMacros.h"
 
@@ -23,20 +24,55 @@ class ESPErrorStatus {
   operator bool() const { return value == ESP_OK; }
 };
 
+// An explicit error code for `DataOrError`, see below.
+struct ESPError {
+  esp_err_t value;
+  constexpr operator esp_err_t() const { return value; }
+};
+
+// Note: when `T` is the same type as `esp_err_t` (e.g. `int32_t`), a bare
+// value could be either data or an error code, so implicit conversion does
+// not compile. Use the `std::in_place` constructor for data, and `ESPError`
+// for errors, e.g. `return ESPError{ESP_ERR_INVALID_ARG};`.
 template <typename T>
 class DataOrError {
+  template <typename U>
+  using IfNotErrType = std::enable_if_t<!std::is_same_v<U, esp_err_t>, int>;
+  template <typename U>
+  using IfErrType = std::enable_if_t<std::is_same_v<U, esp_err_t>, int>;
+
  public:
-  DataOrError() : DataOrError(ESP_FAIL) {}
-  DataOrError(T&& data) { *this = std::move(data); }
-  DataOrError(esp_err_t error) { *this = error; }
+  DataOrError() : DataOrError(ESPError{ESP_FAIL}) {}
+  template <typename U = T, IfNotErrType<U> = 0>
+  DataOrError(T&& data) : data_or_error_(std::in_place_index<0>, std::move(data)) {}
+  // Without this, integral lvalues would silently convert to an error code.
+  template <typename U = T, IfNotErrType<U> = 0>
+  DataOrError(const T& data) : data_or_error_(std::in_place_index<0>, data) {}
+  template <typename U = T, IfNotErrType<U> = 0>
+  DataOrError(esp_err_t error) : DataOrError(ESPError{error}) {}
+  template <typename U = T, IfErrType<U> = 0>
+  DataOrError(esp_err_t) = delete;  // Ambiguous, see above
+  DataOrError(ESPError error) : data_or_error_(std::in_place_index<1>, error.value) {
+    assert(error.value != ESP_OK && "ESP_OK is not an error, supply data instead!");
+  }
+  template <typename... Args>
+  explicit DataOrError(std::in_place_t, Args&&... args)
+      : data_or_error_(std::in_place_index<0>, std::forward<Args>(args)...) {}
 
+  template <typename U = T, IfNotErrType<U> = 0>
   DataOrError& operator=(T&& data) {
     data_or_error_ = std::variant<T, esp_err_t>{std::in_place_index<0>, std::move(data)};
     return *this;
   }
+  template <typename U = T, IfNotErrType<U> = 0>
   DataOrError& operator=(esp_err_t error) {
-    assert(error != ESP_OK && "ESP_OK is not an error, supply data instead!");
-    data_or_error_ = std::variant<T, esp_err_t>{std::in_place_index<1>, error};
+    return *this = ESPError{error};
+  }
+  template <typename U = T, IfErrType<U> = 0>
+  DataOrError& operator=(esp_err_t) = delete;  // Ambiguous, see above
+  DataOrError& operator=(ESPError error) {
+    assert(error.value != ESP_OK && "ESP_OK is not an error, supply data instead!");
+    data_or_error_ = std::variant<T, esp_err_t>{std::in_place_index<1>, error.value};
     return *this;
   }
 
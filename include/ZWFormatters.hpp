@@ -0,0 +1,204 @@
+// Locale-free numeric formatting utilities
+
+#ifndef ZWUTILS_IDF8266_FORMATTERS_H
+#define ZWUTILS_IDF8266_FORMATTERS_H
+
+#include <stdint.h>
+#include <string.h>
+#include <algorithm>
+#include <limits>
+#include <type_traits>
+
+#include "esp_err.h"
+
+#include "ZWDataOrError.hpp"
+#include "ZWDataBuf.hpp"
+
+namespace zw::esp8266::utils {
+
+// In the style of `std::to_chars`, the `Format*()` functions write into
+// [out, out + size) without NUL termination, and return the number of
+// characters written, or ESP_ERR_INVALID_SIZE if the output does not fit.
+// The `Append*()` variants append to a `DataBuf`.
+
+// Maximum number of characters produced by `FormatInt<T>()`.
+template <typename T>
+inline constexpr size_t kMaxIntChars = std::numeric_limits<T>::digits10 + 1 + std::is_signed_v<T>;
+
+// Maximum number of characters produced by `FormatFixed<T, Frac>()`.
+template <typename T, unsigned Frac>
+inline constexpr size_t kMaxFixedChars = kMaxIntChars<T> + Frac + 2;
+
+// Maximum number of characters produced by `FormatFloat()`.
+inline constexpr size_t kMaxFloatChars = 32;
+inline constexpr unsigned kMaxFloatPrecision = 9;
+
+namespace internal {
+
+inline constexpr char kDigitPairs[] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+inline constexpr uint32_t kPow10U32[] = {1,      10,      100,      1000,      10000,
+                                         100000, 1000000, 10000000, 100000000, 1000000000};
+
+// Writes exactly `width` digits (zero padded) ending at `end`.
+inline char* WriteDigitsFixed(char* end, uint32_t val, unsigned width) {
+  for (; width >= 2; width -= 2, val /= 100) memcpy(end -= 2, &kDigitPairs[(val % 100) * 2], 2);
+  if (width) *--end = '0' + val % 10;
+  return end;
+}
+
+// Writes the digits of `val` ending at `end`, returns the first digit position.
+inline char* WriteDigits(char* end, uint32_t val) {
+  while (val >= 100) {
+    memcpy(end -= 2, &kDigitPairs[(val % 100) * 2], 2);
+    val /= 100;
+  }
+  if (val >= 10) {
+    memcpy(end -= 2, &kDigitPairs[val * 2], 2);
+  } else {
+    *--end = '0' + val;
+  }
+  return end;
+}
+
+// 64-bit divisions are expensive library calls on 32-bit cores,
+// so peel off 9-digit chunks and do the rest in 32-bit arithmetic.
+inline char* WriteDigits(char* end, uint64_t val) {
+  while (val > UINT32_MAX) {
+    end = WriteDigitsFixed(end, val % 1000000000, 9);
+    val /= 1000000000;
+  }
+  return WriteDigits(end, (uint32_t)val);
+}
+
+inline DataOrError<size_t> CopyOut(char* out, size_t size, const char* begin, const char* end) {
+  size_t len = end - begin;
+  if (len > size) return ESP_ERR_INVALID_SIZE;
+  memcpy(out, begin, len);
+  return len;
+}
+
+template <typename Formatter>
+void AppendFormatted(DataBuf& buf, size_t max_len, Formatter&& formatter) {
+  size_t old_size = buf.size();
+  buf.resize(old_size + max_len);
+  buf.resize(old_size + *formatter((char*)buf.data() + old_size, max_len));
+}
+
+}  // namespace internal
+
+template <typename T>
+DataOrError<size_t> FormatInt(char* out, size_t size, T val) {
+  static_assert(std::is_integral_v<T> && !std::is_same_v<T, bool>);
+  using U = std::conditional_t<(sizeof(T) > 4), uint64_t, uint32_t>;
+
+  char buf[kMaxIntChars<T>];
+  char* end = buf + sizeof(buf);
+  bool neg = false;
+  if constexpr (std::is_signed_v<T>) neg = val < 0;
+  char* begin = internal::WriteDigits(end, neg ? (U)0 - (U)val : (U)val);
+  if (neg) *--begin = '-';
+  return internal::CopyOut(out, size, begin, end);
+}
+
+// Fixed-point decimal, e.g. `FormatFixed<int32_t, 2>(out, size, -1234)` yields "-12.34".
+template <typename T, unsigned Frac>
+DataOrError<size_t> FormatFixed(char* out, size_t size, T val) {
+  static_assert(std::is_integral_v<T> && !std::is_same_v<T, bool>);
+  static_assert(Frac <= kMaxFloatPrecision, "Fractional digits out of range");
+  using U = std::conditional_t<(sizeof(T) > 4), uint64_t, uint32_t>;
+
+  char buf[kMaxFixedChars<T, Frac>];
+  char* end = buf + sizeof(buf);
+  bool neg = false;
+  if constexpr (std::is_signed_v<T>) neg = val < 0;
+  U abs_val = neg ? (U)0 - (U)val : (U)val;
+  char* begin = end;
+  if constexpr (Frac > 0) {
+    begin = internal::WriteDigitsFixed(begin, abs_val % internal::kPow10U32[Frac], Frac);
+    *--begin = '.';
+    abs_val /= internal::kPow10U32[Frac];
+  }
+  begin = internal::WriteDigits(begin, abs_val);
+  if (neg) *--begin = '-';
+  return internal::CopyOut(out, size, begin, end);
+}
+
+// Formats in fixed notation with `precision` (up to 9) fractional digits,
+// switching to scientific notation for magnitudes of 1e19 and above.
+// Not printf-identical: exact ties round away from zero, where printf rounds
+// half to even, e.g. 0.125 at precision 2 gives "0.13" (printf gives "0.12").
+inline DataOrError<size_t> FormatFloat(char* out, size_t size, double val,
+                                       unsigned precision = 6) {
+  if (precision > kMaxFloatPrecision) return ESP_ERR_INVALID_ARG;
+
+  char buf[kMaxFloatChars];
+  char* end = buf + sizeof(buf);
+  char* begin = end;
+  bool neg = val < 0;
+  if (neg) val = -val;
+
+  if (val != val) {
+    memcpy(begin -= 3, "nan", 3);
+    neg = false;
+  } else if (val > std::numeric_limits<double>::max()) {
+    memcpy(begin -= 3, "inf", 3);
+  } else {
+    int exp10 = 0;
+    if (val >= 1e19) {
+      for (; val >= 1e16; exp10 += 16) val /= 1e16;
+      for (; val >= 10; ++exp10) val /= 10;
+    }
+
+    uint64_t int_part = (uint64_t)val;
+    const uint32_t scale = internal::kPow10U32[precision];
+    uint32_t frac_part = (uint32_t)((val - int_part) * scale + 0.5);
+    if (frac_part >= scale) {
+      frac_part -= scale;
+      ++int_part;
+    }
+    if (exp10 && int_part >= 10) {
+      int_part /= 10;
+      ++exp10;
+    }
+
+    if (exp10) {
+      begin = internal::WriteDigits(begin, (uint32_t)exp10);
+      *--begin = '+';
+      *--begin = 'e';
+    }
+    if (precision) {
+      begin = internal::WriteDigitsFixed(begin, frac_part, precision);
+      *--begin = '.';
+    }
+    begin = internal::WriteDigits(begin, int_part);
+  }
+  if (neg) *--begin = '-';
+  return internal::CopyOut(out, size, begin, end);
+}
+
+template <typename T>
+void AppendInt(DataBuf& buf, T val) {
+  internal::AppendFormatted(buf, kMaxIntChars<T>,
+                            [&](char* out, size_t size) { return FormatInt(out, size, val); });
+}
+
+template <typename T, unsigned Frac>
+void AppendFixed(DataBuf& buf, T val) {
+  internal::AppendFormatted(buf, kMaxFixedChars<T, Frac>, [&](char* out, size_t size) {
+    return FormatFixed<T, Frac>(out, size, val);
+  });
+}
+
+inline void AppendFloat(DataBuf& buf, double val, unsigned precision = 6) {
+  internal::AppendFormatted(buf, kMaxFloatChars, [&](char* out, size_t size) {
+    return FormatFloat(out, size, val, std::min(precision, kMaxFloatPrecision));
+  });
+}
+
+}  // namespace zw::esp8266::utils
+
+#endif  // ZWUTILS_IDF8266_FORMATTERS_H
@@ -0,0 +1,393 @@
+// Zero-copy in-situ JSON tokenizer
+
+#ifndef ZWUTILS_IDF8266_JSONTOKENIZER_H
+#define ZWUTILS_IDF8266_JSONTOKENIZER_H
+
+#include <stdint.h>
+#include <string.h>
+#include <array>
+#include <string_view>
+
+#include "esp_err.h"
+
+#include "ZWDataOrError.hpp"
+#include "ZWParsers.hpp"
+#include "ZWDataBuf.hpp"
+
+namespace zw::esp8266::utils {
+
+// A token refers to a slice of the input by offset and length.
+// String tokens exclude the surrounding quotes.
+struct JsonToken {
+  enum Type : uint8_t { kNull, kBool, kNumber, kString, kArray, kObject };
+  enum Flags : uint8_t { kEscaped = 1, kUnescaped = 2 };
+
+  uint16_t offset;
+  uint16_t length;
+  // Number of array elements, or object key-value pairs.
+  uint16_t members;
+  // Index of the next sibling token, allows skipping a subtree in O(1).
+  uint16_t next;
+  Type type;
+  uint8_t flags;
+};
+
+// Tokenizes a JSON document into a fixed array of (at most N) tokens,
+// no heap allocation is performed. Object members are laid out as a
+// key (string) token immediately followed by the value token(s).
+//
+// The input must be kept alive (and unmodified) while tokens are in use.
+// Input size is limited to 64KB.
+template <size_t N, size_t MaxDepth = 16>
+class JsonTokenizer {
+  static_assert(N > 0 && N <= UINT16_MAX, "Invalid token capacity");
+
+ public:
+  // Tokenize read-only input. Strings containing escapes cannot be decoded.
+  DataOrError<size_t> Parse(std::string_view json) { return Parse_(json, nullptr); }
+
+  // Tokenize mutable input. Strings containing escapes are decoded in place
+  // upon first access. Trailing NUL characters (e.g. from `PrintTo()`) are ignored.
+  DataOrError<size_t> Parse(char* json, size_t len) {
+    while (len && json[len - 1] == '\0') --len;
+    return Parse_({json, len}, json);
+  }
+  DataOrError<size_t> Parse(DataBuf& buf) { return Parse((char*)buf.data(), buf.size()); }
+
+  // Number of tokens from the last successful parse.
+  size_t size() const { return count_; }
+  // Byte position of the last parse error.
+  size_t error_pos() const { return error_pos_; }
+
+  const JsonToken& operator[](size_t idx) const { return tokens_[idx]; }
+
+  // The raw text slice of a token.
+  std::string_view Text(size_t idx) const {
+    return json_.substr(tokens_[idx].offset, tokens_[idx].length);
+  }
+
+  // Returns the index of the value token for `key` in an object.
+  // Keys are compared in their raw (escaped) form, unless previously decoded.
+  DataOrError<size_t> Find(size_t obj, std::string_view key) const {
+    if (tokens_[obj].type != JsonToken::kObject) return ESP_ERR_INVALID_ARG;
+    size_t idx = obj + 1;
+    for (size_t i = 0; i < tokens_[obj].members; ++i) {
+      if (Text(idx) == key) return idx + 1;
+      idx = tokens_[idx + 1].next;
+    }
+    return ESP_ERR_NOT_FOUND;
+  }
+
+  // Returns the index of the n-th element token in an array.
+  DataOrError<size_t> At(size_t arr, size_t n) const {
+    if (tokens_[arr].type != JsonToken::kArray) return ESP_ERR_INVALID_ARG;
+    if (n >= tokens_[arr].members) return ESP_ERR_NOT_FOUND;
+    size_t idx = arr + 1;
+    while (n--) idx = tokens_[idx].next;
+    return idx;
+  }
+
+  bool IsNull(size_t idx) const { return tokens_[idx].type == JsonToken::kNull; }
+
+  DataOrError<bool> GetBool(size_t idx) const {
+    if (tokens_[idx].type != JsonToken::kBool) return ESP_ERR_INVALID_ARG;
+    return Text(idx).front() == 't';
+  }
+
+  // Only integral numbers are accepted, see `ParseInt()`.
+  template <typename T>
+  DataOrError<T> GetInt(size_t idx) const {
+    if (tokens_[idx].type != JsonToken::kNumber) return ESPError{ESP_ERR_INVALID_ARG};
+    return ParseInt<T>(Text(idx));
+  }
+
+  // Returns the decoded string, unescaping in place if needed.
+  DataOrError<std::string_view> GetString(size_t idx) {
+    JsonToken& token = tokens_[idx];
+    if (token.type != JsonToken::kString) return ESP_ERR_INVALID_ARG;
+    if ((token.flags & JsonToken::kEscaped) && !(token.flags & JsonToken::kUnescaped)) {
+      if (mutable_ == nullptr) return ESP_ERR_NOT_SUPPORTED;
+      token.length = Unescape_(mutable_ + token.offset, token.length);
+      token.flags |= JsonToken::kUnescaped;
+    }
+    return Text(idx);
+  }
+
+ private:
+  enum State : uint8_t { kValue, kValueOrEnd, kKey, kKeyOrEnd, kColon, kCommaOrEnd, kDone };
+
+  std::array<JsonToken, N> tokens_;
+  size_t count_ = 0;
+  size_t error_pos_ = 0;
+  std::string_view json_;
+  char* mutable_ = nullptr;
+
+  DataOrError<size_t> Parse_(std::string_view json, char* mutable_json) {
+    count_ = 0;
+    json_ = json;
+    mutable_ = mutable_json;
+    if (json.size() > UINT16_MAX) return Fail_(UINT16_MAX, ESP_ERR_INVALID_SIZE);
+
+    size_t count = 0;
+    esp_err_t err = Tokenize_(count);
+    if (err != ESP_OK) return err;
+    count_ = count;
+    return count;
+  }
+
+  esp_err_t Fail_(size_t pos, esp_err_t err) {
+    error_pos_ = pos;
+    return err;
+  }
+
+  esp_err_t NewToken_(size_t& count, JsonToken::Type type, size_t offset) {
+    if (count >= N) return Fail_(offset, ESP_ERR_NO_MEM);
+    tokens_[count] = {(uint16_t)offset, 0, 0, (uint16_t)(count + 1), type, 0};
+    return ++count, ESP_OK;
+  }
+
+  esp_err_t Tokenize_(size_t& count) {
+    std::array<uint16_t, MaxDepth> stack;
+    size_t depth = 0;
+    State state = kValue;
+    const size_t len = json_.size();
+
+    for (size_t pos = 0;; ++pos) {
+      while (pos < len && IsSpace_(json_[pos])) ++pos;
+      if (pos >= len) break;
+      char c = json_[pos];
+
+      if (c == '}' || c == ']') {
+        bool is_obj = c == '}';
+        if (state == (is_obj ? kKeyOrEnd : kValueOrEnd) ||
+            (state == kCommaOrEnd &&
+             tokens_[stack[depth - 1]].type == (is_obj ? JsonToken::kObject : JsonToken::kArray))) {
+          JsonToken& container = tokens_[stack[--depth]];
+          container.length = pos + 1 - container.offset;
+          container.next = count;
+          state = depth ? kCommaOrEnd : kDone;
+          continue;
+        }
+        return Fail_(pos, ESP_ERR_INVALID_ARG);
+      }
+
+      switch (state) {
+        case kDone:
+          return Fail_(pos, ESP_ERR_INVALID_ARG);
+
+        case kColon:
+          if (c != ':') return Fail_(pos, ESP_ERR_INVALID_ARG);
+          state = kValue;
+          continue;
+
+        case kCommaOrEnd:
+          if (c != ',') return Fail_(pos, ESP_ERR_INVALID_ARG);
+          state = tokens_[stack[depth - 1]].type == JsonToken::kObject ? kKey : kValue;
+          continue;
+
+        case kKey:
+        case kKeyOrEnd: {
+          if (c != '"') return Fail_(pos, ESP_ERR_INVALID_ARG);
+          esp_err_t err = ScanString_(count, pos);
+          if (err != ESP_OK) return err;
+          ++tokens_[stack[depth - 1]].members;
+          state = kColon;
+          continue;
+        }
+
+        default:
+          break;
+      }
+
+      // Expecting a value
+      if (depth && tokens_[stack[depth - 1]].type == JsonToken::kArray)
+        ++tokens_[stack[depth - 1]].members;
+
+      esp_err_t err = ESP_OK;
+      switch (c) {
+        case '{':
+        case '[':
+          if (depth >= MaxDepth) return Fail_(pos, ESP_ERR_INVALID_SIZE);
+          err = NewToken_(count, c == '{' ? JsonToken::kObject : JsonToken::kArray, pos);
+          if (err != ESP_OK) return err;
+          stack[depth++] = count - 1;
+          state = c == '{' ? kKeyOrEnd : kValueOrEnd;
+          continue;
+
+        case '"':
+          err = ScanString_(count, pos);
+          break;
+
+        default:
+          err = ScanPrimitive_(count, pos);
+      }
+      if (err != ESP_OK) return err;
+      state = depth ? kCommaOrEnd : kDone;
+    }
+
+    if (state != kDone) return Fail_(len, ESP_ERR_INVALID_SIZE);
+    return ESP_OK;
+  }
+
+  // On entry `pos` points to the opening quote, on exit to the closing quote.
+  esp_err_t ScanString_(size_t& count, size_t& pos) {
+    const size_t len = json_.size();
+    size_t start = pos + 1;
+    uint8_t flags = 0;
+    bool want_low_surrogate = false;
+
+    for (pos = start;; ++pos) {
+      if (pos >= len) return Fail_(len, ESP_ERR_INVALID_SIZE);
+      char c = json_[pos];
+      if (c == '"' && !want_low_surrogate) break;
+      if ((uint8_t)c < 0x20) return Fail_(pos, ESP_ERR_INVALID_ARG);
+      if (c != '\\') {
+        if (want_low_surrogate) return Fail_(pos, ESP_ERR_INVALID_ARG);
+        continue;
+      }
+
+      flags |= JsonToken::kEscaped;
+      if (++pos >= len) return Fail_(len, ESP_ERR_INVALID_SIZE);
+      c = json_[pos];
+      if (c != 'u') {
+        if (want_low_surrogate || strchr("\"\\/bfnrt", c) == nullptr || c == '\0')
+          return Fail_(pos, ESP_ERR_INVALID_ARG);
+        continue;
+      }
+
+      if (pos + 4 >= len) return Fail_(len, ESP_ERR_INVALID_SIZE);
+      int32_t code = ParseHex4_(json_.data() + pos + 1);
+      if (code < 0) return Fail_(pos, ESP_ERR_INVALID_ARG);
+      bool is_low = code >= 0xDC00 && code <= 0xDFFF;
+      if (is_low != want_low_surrogate) return Fail_(pos, ESP_ERR_INVALID_ARG);
+      want_low_surrogate = code >= 0xD800 && code <= 0xDBFF;
+      pos += 4;
+    }
+
+    esp_err_t err = NewToken_(count, JsonToken::kString, start);
+    if (err != ESP_OK) return err;
+    tokens_[count - 1].length = pos - start;
+    tokens_[count - 1].flags = flags;
+    return ESP_OK;
+  }
+
+  // On entry `pos` points to the first character, on exit to the last.
+  esp_err_t ScanPrimitive_(size_t& count, size_t& pos) {
+    size_t start = pos;
+    while (pos < json_.size() && !IsSpace_(json_[pos]) && strchr(",]}", json_[pos]) == nullptr)
+      ++pos;
+    std::string_view text = json_.substr(start, pos - start);
+
+    JsonToken::Type type;
+    if (text == "null") {
+      type = JsonToken::kNull;
+    } else if (text == "true" || text == "false") {
+      type = JsonToken::kBool;
+    } else if (IsNumber_(text)) {
+      type = JsonToken::kNumber;
+    } else {
+      return Fail_(start, ESP_ERR_INVALID_ARG);
+    }
+
+    esp_err_t err = NewToken_(count, type, start);
+    if (err != ESP_OK) return err;
+    tokens_[count - 1].length = text.size();
+    return --pos, ESP_OK;
+  }
+
+  static bool IsSpace_(char c) { return c == ' ' || c == '\t' || c == '\n' || c == '\r'; }
+
+  // -?(0|[1-9][0-9]*)(\.[0-9]+)?([eE][+-]?[0-9]+)?
+  static bool IsNumber_(std::string_view text) {
+    size_t i = 0, len = text.size();
+    auto digits = [&] {
+      size_t start = i;
+      while (i < len && ParseDec(text[i]) >= 0) ++i;
+      return i > start;
+    };
+
+    if (i < len && text[i] == '-') ++i;
+    if (i < len && text[i] == '0') {
+      ++i;
+    } else if (!digits()) {
+      return false;
+    }
+    if (i < len && text[i] == '.') {
+      ++i;
+      if (!digits()) return false;
+    }
+    if (i < len && (text[i] == 'e' || text[i] == 'E')) {
+      ++i;
+      if (i < len && (text[i] == '+' || text[i] == '-')) ++i;
+      if (!digits()) return false;
+    }
+    return i == len;
+  }
+
+  static int32_t ParseHex4_(const char* in_ptr) {
+    int32_t code = 0;
+    for (int i = 0; i < 4; ++i) {
+      int8_t h = ParseHex(*in_ptr++);
+      if (h < 0) return -1;
+      code = (code << 4) | h;
+    }
+    return code;
+  }
+
+  // Escapes were validated during tokenization, decoding cannot fail
+  // and never grows the string.
+  static size_t Unescape_(char* str, size_t len) {
+    const char* in_ptr = str;
+    const char* in_end = str + len;
+    char* out_ptr = str;
+
+    while (in_ptr < in_end) {
+      char c = *in_ptr++;
+      if (c != '\\') {
+        *out_ptr++ = c;
+        continue;
+      }
+      switch (c = *in_ptr++) {
+        case 'b': *out_ptr++ = '\b'; break;
+        case 'f': *out_ptr++ = '\f'; break;
+        case 'n': *out_ptr++ = '\n'; break;
+        case 'r': *out_ptr++ = '\r'; break;
+        case 't': *out_ptr++ = '\t'; break;
+        case 'u': {
+          uint32_t code = ParseHex4_(in_ptr);
+          in_ptr += 4;
+          if (code >= 0xD800 && code <= 0xDBFF) {
+            code = 0x10000 + ((code - 0xD800) << 10) + (ParseHex4_(in_ptr + 2) - 0xDC00);
+            in_ptr += 6;
+          }
+          out_ptr = EncodeUtf8_(out_ptr, code);
+        } break;
+        default: *out_ptr++ = c;
+      }
+    }
+    return out_ptr - str;
+  }
+
+  static char* EncodeUtf8_(char* out_ptr, uint32_t code) {
+    if (code < 0x80) {
+      *out_ptr++ = code;
+    } else if (code < 0x800) {
+      *out_ptr++ = 0xC0 | (code >> 6);
+      *out_ptr++ = 0x80 | (code & 0x3F);
+    } else if (code < 0x10000) {
+      *out_ptr++ = 0xE0 | (code >> 12);
+      *out_ptr++ = 0x80 | ((code >> 6) & 0x3F);
+      *out_ptr++ = 0x80 | (code & 0x3F);
+    } else {
+      *out_ptr++ = 0xF0 | (code >> 18);
+      *out_ptr++ = 0x80 | ((code >> 12) & 0x3F);
+      *out_ptr++ = 0x80 | ((code >> 6) & 0x3F);
+      *out_ptr++ = 0x80 | (code & 0x3F);
+    }
+    return out_ptr;
+  }
+};
+
+}  // namespace zw::esp8266::utils
+
+#endif  // ZWUTILS_IDF8266_JSONTOKENIZER_H
@@ -25,15 +25,15 @@
     }                                                      \
   }
 #else
-#define ZW_RETURN_ON_ERROR(expression, cleanup, ret_clean)                                  \
-  {                                                                                         \
-    esp_err_t __err_rc = (expression);                                                      \
-    cleanup;                                                                                \
-    if (__err_rc != ESP_OK) {                                                               \
-      ESP_LOGD(TAG, "ESP Error (%s:%d) %d (0x%x)", __FILE__, __LINE__, __err_rc, __err_rc); \
-      ret_clean;                                                                            \
-      return __err_rc;                                                                      \
-    }                                                                                       \
+#define ZW_RETURN_ON_ERROR(expression, cleanup, ret_clean) \
+  {                                                        \
+    esp_err_t __err_rc = (expression);                     \
+    cleanup;                                               \
+    if (__err_rc != ESP_OK) {                              \
+      ZW_LOG_ESP_ERROR(__err_rc);                          \
+      ret_clean;                                           \
+      return __err_rc;                                     \
+    }                                                      \
   }
 #endif
 
@@ -48,15 +48,15 @@
     }                                                     \
   }
 #else
-#define ZW_BREAK_ON_ERROR(expression, cleanup, ret_clean)                                   \
-  {                                                                                         \
-    esp_err_t __err_rc = (expression);                                                      \
-    cleanup;                                                                                \
-    if (__err_rc != ESP_OK) {                                                               \
-      ESP_LOGD(TAG, "ESP Error (%s:%d) %d (0x%x)", __FILE__, __LINE__, __err_rc, __err_rc); \
-      ret_clean;                                                                            \
-      break;                                                                                \
-    }                                                                                       \
+#define ZW_BREAK_ON_ERROR(expression, cleanup, ret_clean) \
+  {                                                       \
+    esp_err_t __err_rc = (expression);                    \
+    cleanup;                                              \
+    if (__err_rc != ESP_OK) {                             \
+      ZW_LOG_ESP_ERROR(__err_rc);                         \
+      ret_clean;                                          \
+      break;                                              \
+    }                                                     \
   }
 #endif
 
@@ -4,7 +4,12 @@
 #ifndef ZWUTILS_IDF8266_PARSERS_H
 #define ZWUTILS_IDF8266_PARSERS_H
 
+#include <stdint.h>
+#include <array>
 #include <string>
+#include <string_view>
+#include <limits>
+#include <type_traits>
 
 #include "esp_err.h"
 
@@ -12,13 +17,187 @@
 
 namespace zw::esp8266::utils {
 
+namespace internal {
+
+// Hex digit values (either letter case), 0xFF for anything else.
+constexpr std::array<uint8_t, 256> MakeHexDecodeTable() {
+  std::array<uint8_t, 256> table{};
+  for (auto& entry : table) entry = 0xFF;
+  for (size_t i = 0; i < 10; ++i) table['0' + i] = i;
+  for (size_t i = 0; i < 6; ++i) table['a' + i] = table['A' + i] = 10 + i;
+  return table;
+}
+
+inline constexpr auto kHexDecode = MakeHexDecodeTable();
+
+}  // namespace internal
+
 inline int8_t ParseHex(char c) {
+  return (int8_t)internal::kHexDecode[(uint8_t)c];  // -1 on error
+}
+
+inline int8_t ParseDec(char c) {
   if (c >= '0' && c <= '9') return c - '0';
-  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
-  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
   return -1;  // Error
 }
 
+//---------------------------
+// Locale-free numeric parsing
+//---------------------------
+// The `Consume*()` variants parse from the front of the input (in the style
+// of `std::from_chars`), and on success advance `in` past the parsed text.
+// The `Parse*()` variants require the whole input to be consumed.
+// Errors: ESP_ERR_INVALID_ARG on malformed input, ESP_ERR_INVALID_SIZE on overflow.
+//
+// Integers take an optional '-' sign only, a leading '+' is malformed; floats
+// take either sign (as `strtod()` does).
+
+template <typename T>
+DataOrError<T> ConsumeInt(std::string_view& in) {
+  static_assert(std::is_integral_v<T> && !std::is_same_v<T, bool>);
+  using U = std::make_unsigned_t<T>;
+
+  bool neg = std::is_signed_v<T> && !in.empty() && in.front() == '-';
+  const U limit = (U)std::numeric_limits<T>::max() + (neg ? 1 : 0);
+  // Up to `digits10` digits never overflow, skip the range check for those
+  const size_t safe_end = neg + std::numeric_limits<T>::digits10;
+
+  size_t pos = neg;
+  U val = 0;
+  for (; pos < in.size(); ++pos) {
+    int8_t d = ParseDec(in[pos]);
+    if (d < 0) break;
+    if (pos >= safe_end && val > (U)(limit - d) / 10) return ESPError{ESP_ERR_INVALID_SIZE};
+    val = val * 10 + d;
+  }
+  if (pos == (size_t)neg) return ESPError{ESP_ERR_INVALID_ARG};
+
+  in.remove_prefix(pos);
+  return DataOrError<T>(std::in_place, neg ? (T)(U)(0 - val) : (T)val);
+}
+
+// Fixed-point decimal, e.g. `ConsumeFixed<int32_t, 2>("-12.345")` yields -1234.
+// Fractional digits beyond `Frac` are consumed but truncated.
+template <typename T, unsigned Frac>
+DataOrError<T> ConsumeFixed(std::string_view& in) {
+  static_assert(std::is_integral_v<T> && !std::is_same_v<T, bool>);
+  using U = std::make_unsigned_t<T>;
+
+  bool neg = std::is_signed_v<T> && !in.empty() && in.front() == '-';
+  const U limit = (U)std::numeric_limits<T>::max() + (neg ? 1 : 0);
+
+  U val = 0;
+  auto push_digit = [&](int8_t d) {
+    if (val > (U)(limit - d) / 10) return false;
+    return val = val * 10 + d, true;
+  };
+
+  size_t pos = neg, digits = 0;
+  for (int8_t d; pos < in.size() && (d = ParseDec(in[pos])) >= 0; ++pos, ++digits)
+    if (!push_digit(d)) return ESPError{ESP_ERR_INVALID_SIZE};
+
+  unsigned frac_digits = 0;
+  if (pos < in.size() && in[pos] == '.') {
+    for (int8_t d; ++pos < in.size() && (d = ParseDec(in[pos])) >= 0; ++digits) {
+      if (frac_digits < Frac && (++frac_digits, !push_digit(d)))
+        return ESPError{ESP_ERR_INVALID_SIZE};
+    }
+  }
+  if (digits == 0) return ESPError{ESP_ERR_INVALID_ARG};
+  for (; frac_digits < Frac; ++frac_digits)
+    if (!push_digit(0)) return ESPError{ESP_ERR_INVALID_SIZE};
+
+  in.remove_prefix(pos);
+  return DataOrError<T>(std::in_place, neg ? (T)(U)(0 - val) : (T)val);
+}
+
+// Floating point in plain or scientific notation (no "inf" / "nan").
+// Up to 19 significant digits are used. The result is correctly rounded when
+// both the significand and the power of 10 are exactly representable (i.e. most
+// human-written values), otherwise it may be off by a few ULPs.
+template <typename T>
+DataOrError<T> ConsumeFloat(std::string_view& in) {
+  static_assert(std::is_floating_point_v<T>);
+  static constexpr double kPow10[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+                                      1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+                                      1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+  static constexpr int kMaxPow10 = 22;
+
+  size_t pos = (!in.empty() && (in.front() == '-' || in.front() == '+')) ? 1 : 0;
+  bool neg = pos && in.front() == '-';
+
+  uint64_t mantissa = 0;
+  int exp10 = 0;
+  size_t digits = 0;
+  auto push_digit = [&](int8_t d, int exp_adj) {
+    if (mantissa < 1000000000000000000ULL) {
+      mantissa = mantissa * 10 + d;
+      exp10 += exp_adj;
+    } else {
+      exp10 += exp_adj + 1;  // Excess precision is dropped
+    }
+  };
+
+  for (int8_t d; pos < in.size() && (d = ParseDec(in[pos])) >= 0; ++pos, ++digits)
+    push_digit(d, 0);
+  if (pos < in.size() && in[pos] == '.') {
+    for (int8_t d; ++pos < in.size() && (d = ParseDec(in[pos])) >= 0; ++digits) push_digit(d, -1);
+  }
+  if (digits == 0) return ESP_ERR_INVALID_ARG;
+
+  // The exponent is only consumed when well-formed
+  if (pos < in.size() && (in[pos] == 'e' || in[pos] == 'E')) {
+    std::string_view exp_str = in.substr(pos + 1);
+    bool exp_neg = !exp_str.empty() && exp_str.front() == '-';
+    if (!exp_str.empty() && (exp_neg || exp_str.front() == '+')) exp_str.remove_prefix(1);
+    // Digits only from here, the sign is already consumed
+    DataOrError<uint16_t> exp = ConsumeInt<uint16_t>(exp_str);
+    if (exp) {
+      exp10 += exp_neg ? -(int)*exp : (int)*exp;
+      pos = in.size() - exp_str.size();
+    } else if (exp.error() == ESP_ERR_INVALID_SIZE) {
+      // Absurdly large exponent, saturate
+      exp10 += exp_neg ? -30000 : 30000;
+      pos = in.size() - exp_str.size();
+      while (pos < in.size() && ParseDec(in[pos]) >= 0) ++pos;
+    }
+  }
+
+  double val = (double)mantissa;
+  if (mantissa != 0) {
+    if (exp10 > 308 + kMaxPow10) return ESP_ERR_INVALID_SIZE;
+    if (exp10 < -(324 + 19)) exp10 = -(324 + 19);
+    for (; exp10 > kMaxPow10; exp10 -= kMaxPow10) val *= kPow10[kMaxPow10];
+    for (; exp10 < -kMaxPow10; exp10 += kMaxPow10) val /= kPow10[kMaxPow10];
+    val = exp10 < 0 ? val / kPow10[-exp10] : val * kPow10[exp10];
+    if ((T)val > std::numeric_limits<T>::max()) return ESP_ERR_INVALID_SIZE;
+  }
+
+  in.remove_prefix(pos);
+  return (T)(neg ? -val : val);
+}
+
+template <typename T>
+DataOrError<T> ParseInt(std::string_view in) {
+  DataOrError<T> result = ConsumeInt<T>(in);
+  if (result && !in.empty()) return ESPError{ESP_ERR_INVALID_ARG};
+  return result;
+}
+
+template <typename T, unsigned Frac>
+DataOrError<T> ParseFixed(std::string_view in) {
+  DataOrError<T> result = ConsumeFixed<T, Frac>(in);
+  if (result && !in.empty()) return ESPError{ESP_ERR_INVALID_ARG};
+  return result;
+}
+
+template <typename T>
+DataOrError<T> ParseFloat(std::string_view in) {
+  DataOrError<T> result = ConsumeFloat<T>(in);
+  if (result && !in.empty()) return ESPError{ESP_ERR_INVALID_ARG};
+  return result;
+}
+
 inline DataOrError<uint8_t> ParseHexByte(const char* in_ptr) {
   int8_t h1 = ParseHex(*in_ptr++);
   if (h1 < 0) return ESP_ERR_INVALID_ARG;
@@ -0,0 +1,83 @@
+// String concatenation with a single allocation
+
+#ifndef ZWUTILS_IDF8266_STRCAT_H
+#define ZWUTILS_IDF8266_STRCAT_H
+
+#include <algorithm>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include "ZWDataBuf.hpp"
+#include "ZWFormatters.hpp"
+#include "ZWStrings.hpp"
+
+namespace zw::esp8266::utils {
+
+// A piece of text for `StrCat()` and `StrAppend()`. Strings are referenced,
+// numbers are formatted into inline storage, so pieces are not copyable.
+class StrPiece {
+ public:
+  StrPiece(const char* str) : view_(str) {}
+  StrPiece(std::string_view str) : view_(str) {}
+  StrPiece(const std::string& str) : view_(str) {}
+  template <size_t N>
+  StrPiece(const InlineString<N>& str) : view_(str) {}
+  StrPiece(char c) : view_(buf_, 1) { buf_[0] = c; }
+
+  template <typename T, typename = std::enable_if_t<std::is_integral_v<T> &&
+                                                    !std::is_same_v<T, bool> &&
+                                                    !std::is_same_v<T, char>>>
+  StrPiece(T val) : view_(buf_, *FormatInt(buf_, sizeof(buf_), val)) {}
+  StrPiece(double val) : view_(buf_, *FormatFloat(buf_, sizeof(buf_), val)) {}
+
+  StrPiece(const StrPiece&) = delete;
+  StrPiece& operator=(const StrPiece&) = delete;
+
+  std::string_view view() const { return view_; }
+  size_t size() const { return view_.size(); }
+
+ private:
+  char buf_[std::max(kMaxIntChars<int64_t>, kMaxFloatChars)];
+  std::string_view view_;
+};
+
+namespace internal {
+
+template <typename Dest>
+void StrAppendPieces(Dest& dest, std::initializer_list<std::string_view> pieces) {
+  size_t total = dest.size();
+  for (std::string_view piece : pieces) total += piece.size();
+  // Grow geometrically, so appending in a loop stays linear
+  if (total > dest.capacity()) dest.reserve(std::max(total, 2 * dest.capacity()));
+  for (std::string_view piece : pieces) dest.insert(dest.end(), piece.begin(), piece.end());
+}
+
+}  // namespace internal
+
+// Concatenate strings, characters and numbers, with exactly one allocation
+// (or none, if the result fits the `std::string` small buffer).
+//   std::string url = StrCat("http://", host, ':', port, path);
+template <typename... Pieces>
+std::string StrCat(const Pieces&... pieces) {
+  std::string result;
+  internal::StrAppendPieces(result, {StrPiece(pieces).view()...});
+  return result;
+}
+
+// Append pieces to an existing string or data buffer, with at most one reallocation
+// (growing the capacity geometrically, as `push_back()` does).
+template <typename... Pieces>
+void StrAppend(std::string& dest, const Pieces&... pieces) {
+  internal::StrAppendPieces(dest, {StrPiece(pieces).view()...});
+}
+
+template <typename... Pieces>
+void StrAppend(DataBuf& dest, const Pieces&... pieces) {
+  internal::StrAppendPieces(dest, {StrPiece(pieces).view()...});
+}
+
+}  // namespace zw::esp8266::utils
+
+#endif  // ZWUTILS_IDF8266_STRCAT_H
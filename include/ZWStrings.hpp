@@ -3,7 +3,15 @@
 #ifndef ZWUTILS_IDF8266_STRINGS_H
 #define ZWUTILS_IDF8266_STRINGS_H
 
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <array>
 #include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
 
 namespace zw::esp8266::utils {
 
@@ -13,6 +21,291 @@ constexpr size_t STRLEN(char const (&)[N]) {
   return N - 1;
 }
 
+// Constexpr string hash (32-bit FNV-1a, same as `Fnv1a32()`), produces identical
+// results at compile-time and run-time. Different strings may share a hash, so
+// when switching on it, confirm the key inside the case:
+//   switch (StrHash(key)) {
+//     case "Content-Type"_strhash:
+//       if (key == "Content-Type") ...
+//   }
+// or better, use a `StringMap`, which does that by itself.
+constexpr uint32_t StrHash(std::string_view str, uint32_t seed = 0) {
+  uint32_t hash = 0x811C9DC5 ^ seed;
+  for (char c : str) hash = (hash ^ (uint8_t)c) * 0x01000193;
+  return hash;
+}
+
+constexpr uint32_t operator""_strhash(const char* str, size_t len) { return StrHash({str, len}); }
+
+namespace internal {
+
+// Deliberately not constexpr, calling it in a constant expression fails the compilation.
+inline void StringMapBuildFailed([[maybe_unused]] const char* reason) { abort(); }
+
+constexpr uint32_t StringMapMix(uint32_t hash, uint32_t disp) {
+  hash ^= disp * 0x9E3779B9;
+  hash = (hash ^ (hash >> 16)) * 0x85EBCA6B;
+  hash = (hash ^ (hash >> 13)) * 0xC2B2AE35;
+  return hash ^ (hash >> 16);
+}
+
+constexpr size_t NextPow2(size_t n) {
+  size_t result = 1;
+  while (result < n) result <<= 1;
+  return result;
+}
+
+}  // namespace internal
+
+// An immutable string-keyed map, with a perfect hash function computed at
+// compile-time. A lookup costs one string hash and one string compare.
+// Declare as `static constexpr` so the tables are placed in rodata, e.g.:
+//
+//   static constexpr auto kMethods = MakeStringMap<Method>({
+//       {"GET", Method::kGet},
+//       {"POST", Method::kPost},
+//   });
+//
+// This also serves as a `switch` on strings:
+//
+//   switch (kMethods.Get(method, Method::kUnknown)) {
+//     case Method::kGet: ...
+//   }
+//
+// `V` must be a literal type and default constructible.
+template <typename V, size_t N>
+class StringMap {
+  static_assert(N > 0 && N <= 16384, "Unsupported number of keys");
+  static constexpr size_t kSlots = internal::NextPow2(N);
+  static constexpr size_t kMask = kSlots - 1;
+  // Give up searching for a displacement beyond this, and retry with another seed
+  static constexpr int16_t kMaxDisp = 2048;
+
+ public:
+  using Item = std::pair<std::string_view, V>;
+
+  constexpr StringMap(const Item (&items)[N]) { Build(items); }
+  constexpr StringMap(const std::array<Item, N>& items) { Build(items); }
+
+  constexpr const V* Find(std::string_view key) const {
+    size_t slot = FindSlot(key);
+    return slot < kSlots ? &values_[slot] : nullptr;
+  }
+
+  constexpr bool Contains(std::string_view key) const { return FindSlot(key) < kSlots; }
+
+  constexpr V Get(std::string_view key, V default_value) const {
+    size_t slot = FindSlot(key);
+    return slot < kSlots ? values_[slot] : default_value;
+  }
+
+  constexpr size_t size() const { return N; }
+
+ private:
+  uint32_t seed_ = 0;
+  // Per-bucket: 0 = empty, < 0 = -(slot + 1), > 0 = displacement for `StringMapMix()`
+  std::array<int16_t, kSlots> disp_{};
+  std::array<std::string_view, kSlots> keys_{};
+  std::array<V, kSlots> values_{};
+
+  // Returns `kSlots` if not found
+  constexpr size_t FindSlot(std::string_view key) const {
+    uint32_t hash = StrHash(key, seed_);
+    int16_t disp = disp_[hash & kMask];
+    if (disp == 0) return kSlots;
+    size_t slot = disp < 0 ? -disp - 1 : internal::StringMapMix(hash, disp) & kMask;
+    return (keys_[slot].data() != nullptr && keys_[slot] == key) ? slot : kSlots;
+  }
+
+  // Hash-and-displace: keys are hashed into buckets, then for each bucket
+  // (largest first), a displacement that maps all its keys to free slots is
+  // searched for. Single-key buckets are directly assigned a free slot.
+  template <typename Items>
+  constexpr void Build(const Items& items) {
+    for (seed_ = 0;; ++seed_) {
+      if (TryBuild(items)) break;
+      if (seed_ >= 64) internal::StringMapBuildFailed("Unable to find a perfect hash");
+    }
+    for (size_t i = 0; i < N; ++i) {
+      uint32_t hash = StrHash(items[i].first, seed_);
+      int16_t disp = disp_[hash & kMask];
+      size_t slot = disp < 0 ? -disp - 1 : internal::StringMapMix(hash, disp) & kMask;
+      keys_[slot] = items[i].first;
+      values_[slot] = items[i].second;
+    }
+  }
+
+  template <typename Items>
+  constexpr bool TryBuild(const Items& items) {
+    std::array<uint32_t, N> hashes{};
+    std::array<uint16_t, kSlots> bucket_sizes{};
+    size_t max_bucket_size = 0;
+    for (size_t i = 0; i < N; ++i) {
+      hashes[i] = StrHash(items[i].first, seed_);
+      for (size_t j = 0; j < i; ++j) {
+        if (hashes[j] != hashes[i]) continue;
+        if (items[j].first == items[i].first) internal::StringMapBuildFailed("Duplicate key");
+        return false;  // Full hash collision, try another seed
+      }
+      size_t bucket_size = ++bucket_sizes[hashes[i] & kMask];
+      if (bucket_size > max_bucket_size) max_bucket_size = bucket_size;
+    }
+
+    disp_ = {};
+    std::array<bool, kSlots> occupied{};
+    for (size_t size = max_bucket_size; size > 1; --size) {
+      for (size_t bucket = 0; bucket < kSlots; ++bucket) {
+        if (bucket_sizes[bucket] != size) continue;
+        std::array<size_t, kSlots> slots{};
+        int16_t disp = 1;
+        for (; disp < kMaxDisp; ++disp) {
+          size_t count = 0;
+          for (size_t i = 0; i < N && count < size; ++i) {
+            if ((hashes[i] & kMask) != bucket) continue;
+            size_t slot = internal::StringMapMix(hashes[i], disp) & kMask;
+            bool taken = occupied[slot];
+            for (size_t k = 0; k < count && !taken; ++k) taken = slots[k] == slot;
+            if (taken) break;
+            slots[count++] = slot;
+          }
+          if (count == size) break;
+        }
+        if (disp == kMaxDisp) return false;
+        for (size_t k = 0; k < size; ++k) occupied[slots[k]] = true;
+        disp_[bucket] = disp;
+      }
+    }
+
+    size_t free_slot = 0;
+    for (size_t bucket = 0; bucket < kSlots; ++bucket) {
+      if (bucket_sizes[bucket] != 1) continue;
+      while (occupied[free_slot]) ++free_slot;
+      occupied[free_slot] = true;
+      disp_[bucket] = -(int16_t)(free_slot + 1);
+    }
+    return true;
+  }
+};
+
+template <typename V, size_t N>
+constexpr StringMap<V, N> MakeStringMap(const std::pair<std::string_view, V> (&items)[N]) {
+  return StringMap<V, N>(items);
+}
+
+template <typename V, size_t N>
+constexpr StringMap<V, N> MakeStringMap(
+    const std::array<std::pair<std::string_view, V>, N>& items) {
+  return StringMap<V, N>(items);
+}
+
+// Fixed-capacity string with inline storage (no heap allocation), and
+// a subset of the `std::string` interface. Always NUL terminated.
+// Content exceeding the capacity is truncated, check `full()` if it matters.
+template <size_t N>
+class InlineString {
+ public:
+  using value_type = char;
+  using size_type = size_t;
+  using iterator = char*;
+  using const_iterator = const char*;
+  static constexpr size_t npos = std::string_view::npos;
+
+  constexpr InlineString() = default;
+  constexpr InlineString(const char* str) { append(std::string_view(str)); }
+  constexpr InlineString(std::string_view str) { append(str); }
+  constexpr InlineString(size_t count, char c) { append(count, c); }
+
+  constexpr size_t size() const { return size_; }
+  constexpr size_t length() const { return size_; }
+  static constexpr size_t capacity() { return N; }
+  static constexpr size_t max_size() { return N; }
+  constexpr bool empty() const { return size_ == 0; }
+  constexpr bool full() const { return size_ == N; }
+
+  constexpr char* data() { return data_; }
+  constexpr const char* data() const { return data_; }
+  constexpr const char* c_str() const { return data_; }
+  std::string str() const { return std::string(data_, size_); }
+  constexpr operator std::string_view() const { return {data_, size_}; }
+
+  constexpr iterator begin() { return data_; }
+  constexpr iterator end() { return data_ + size_; }
+  constexpr const_iterator begin() const { return data_; }
+  constexpr const_iterator end() const { return data_ + size_; }
+  constexpr const_iterator cbegin() const { return data_; }
+  constexpr const_iterator cend() const { return data_ + size_; }
+
+  constexpr char& operator[](size_t pos) { return data_[pos]; }
+  constexpr char operator[](size_t pos) const { return data_[pos]; }
+  constexpr char& front() { return data_[0]; }
+  constexpr char front() const { return data_[0]; }
+  constexpr char& back() { return data_[size_ - 1]; }
+  constexpr char back() const { return data_[size_ - 1]; }
+
+  constexpr void clear() { SetSize(0); }
+  constexpr void resize(size_t count, char c = '\0') {
+    count = std::min(count, N);
+    for (size_t i = size_; i < count; ++i) data_[i] = c;
+    SetSize(count);
+  }
+  constexpr void push_back(char c) {
+    if (size_ < N) data_[size_++] = c;
+  }
+  constexpr void pop_back() { SetSize(size_ - 1); }
+
+  constexpr InlineString& assign(std::string_view str) {
+    clear();
+    return append(str);
+  }
+  constexpr InlineString& append(std::string_view str) {
+    size_t count = std::min(str.size(), N - size_);
+    for (size_t i = 0; i < count; ++i) data_[size_ + i] = str[i];
+    SetSize(size_ + count);
+    return *this;
+  }
+  constexpr InlineString& append(size_t count, char c) {
+    resize(size_ + std::min(count, N - size_), c);
+    return *this;
+  }
+  constexpr InlineString& operator+=(std::string_view str) { return append(str); }
+  constexpr InlineString& operator+=(char c) {
+    push_back(c);
+    return *this;
+  }
+
+  constexpr size_t find(std::string_view str, size_t pos = 0) const {
+    return std::string_view(*this).find(str, pos);
+  }
+  constexpr size_t find(char c, size_t pos = 0) const {
+    return std::string_view(*this).find(c, pos);
+  }
+  constexpr InlineString substr(size_t pos = 0, size_t count = npos) const {
+    return InlineString(std::string_view(*this).substr(pos, count));
+  }
+  constexpr int compare(std::string_view str) const {
+    return std::string_view(*this).compare(str);
+  }
+
+  friend constexpr bool operator==(const InlineString& a, std::string_view b) {
+    return std::string_view(a) == b;
+  }
+  friend constexpr bool operator==(std::string_view a, const InlineString& b) { return b == a; }
+  friend constexpr bool operator!=(const InlineString& a, std::string_view b) { return !(a == b); }
+  friend constexpr bool operator!=(std::string_view a, const InlineString& b) { return !(b == a); }
+  friend constexpr bool operator<(const InlineString& a, std::string_view b) {
+    return a.compare(b) < 0;
+  }
+
+ private:
+  size_t size_ = 0;
+  char data_[N + 1] = {};
+
+  constexpr void SetSize(size_t size) {
+    size_ = size;
+    data_[size_] = '\0';
+  }
+};
+
 // Redact password by keeping only the first and last character.
 inline std::string PasswordRedact(const std::string& input) {
   std::string result(input.length(), '*');
@@ -23,6 +316,19 @@ inline std::string PasswordRedact(const std::string& input) {
   return result;
 }
 
+// Heap-free variant, e.g. `PasswordRedact<32>(password)`.
+// Inputs longer than `N` are shortened in the middle.
+template <size_t N>
+InlineString<N> PasswordRedact(std::string_view input) {
+  static_assert(N >= 2);
+  InlineString<N> result(std::min(input.length(), N), '*');
+  if (!input.empty()) {
+    result.front() = input.front();
+    result.back() = input.back();
+  }
+  return result;
+}
+
 }  // namespace zw::esp8266::utils
 
 #endif  // ZWUTILS_IDF8266_STRINGS_H
\ No newline at end of file
@@ -0,0 +1,295 @@
+// Hashed timer wheel for bulk timeouts
+
+#ifndef ZWUTILS_IDF8266_TIMERWHEEL_H
+#define ZWUTILS_IDF8266_TIMERWHEEL_H
+
+#include <stdint.h>
+#include <utility>
+
+#include "esp_err.h"
+
+#include "FreeRTOS.h"
+#include "freertos/event_groups.h"
+#include "freertos/task.h"
+
+#include "ZWDataOrError.hpp"
+
+namespace zw::esp8266::utils {
+
+// Manages up to `Capacity` concurrent one-shot timers in a fixed pool, with
+// O(1) arm, cancel and expiry, at about 20 bytes per timer. Expiry is delivered
+// by setting event group bits (pairs with `ZW_WAIT_FOR_EVENTS()`), or calling
+// a function.
+//
+// The wheel has no clock of its own: time is measured in abstract ticks, and
+// advanced by calling `Advance(now)`, typically from a service task with
+// `xTaskGetTickCount()`, or from a test with a simulated clock. Each of the
+// `Slots` buckets holds timers due in the same tick modulo `Slots`, so pick
+// `Slots` close to the typical timeout (in ticks) to avoid rescanning.
+//
+//   static TimerWheel<128> wheel;
+//   ASSIGN_OR_RETURN(TimerWheel<128>::Timer timeout, wheel.Arm(ticks, events, TIMEOUT_BIT));
+//   ZW_BLOCK_FOR_EVENTS(events, DATA_BIT | TIMEOUT_BIT, ...);
+//   // `timeout` is cancelled when it goes out of scope
+//
+// All methods can be called from any task. Expiry actions run in the task
+// calling `Advance()`, outside of critical sections, and may arm new timers.
+// Due timers are collected in small batches before their actions run, so
+// cancelling a timer due in the same tick from an action may be too late.
+template <size_t Capacity, size_t Slots = 64>
+class TimerWheel {
+  static_assert(Capacity > 0 && Capacity < UINT16_MAX, "Unsupported capacity");
+  static_assert(Slots > 0 && (Slots & (Slots - 1)) == 0, "Slots must be a power of 2");
+
+  using Index = uint16_t;
+  static constexpr Index kNone = UINT16_MAX;
+  static constexpr size_t kExpireBatch = 8;
+
+ public:
+  using Callback = void (*)(void* arg);
+
+  // RAII handle of an armed timer, cancels the timer when destroyed.
+  // Harmless to keep after the timer has expired.
+  class Timer {
+    using _class = Timer;
+
+   public:
+    Timer() = default;
+    ~Timer() { Cancel(); }
+
+    Timer(const _class&) = delete;
+    Timer& operator=(const _class&) = delete;
+
+    Timer(_class&& in) { *this = std::move(in); }
+    Timer& operator=(_class&& in) {
+      Cancel();
+      std::swap(wheel_, in.wheel_);
+      index_ = in.index_;
+      generation_ = in.generation_;
+      return *this;
+    }
+
+    // Returns true if the timer was pending and is now cancelled.
+    bool Cancel() {
+      if (wheel_ == nullptr) return false;
+      bool result = wheel_->Cancel_(index_, generation_);
+      wheel_ = nullptr;
+      return result;
+    }
+
+    // Push the deadline to `delay` ticks from now, returns false if already expired.
+    // Handy for idle timeouts.
+    bool Rearm(uint32_t delay) {
+      return wheel_ != nullptr && wheel_->Rearm_(index_, generation_, delay);
+    }
+
+    bool pending() const { return wheel_ != nullptr && wheel_->Pending_(index_, generation_); }
+
+    // Detach from the timer, which will then expire normally.
+    void Drop(void) { wheel_ = nullptr; }
+
+   private:
+    friend class TimerWheel;
+
+    Timer(TimerWheel* wheel, Index index, uint16_t generation)
+        : wheel_(wheel), index_(index), generation_(generation) {}
+
+    TimerWheel* wheel_ = nullptr;
+    Index index_ = kNone;
+    uint16_t generation_ = 0;
+  };
+
+  explicit TimerWheel(uint32_t now = 0) : now_(now) {
+    for (Index& head : slots_) head = kNone;
+    for (size_t i = 0; i < Capacity; ++i) nodes_[i].next = i + 1 < Capacity ? i + 1 : kNone;
+    free_ = 0;
+  }
+
+  TimerWheel(const TimerWheel&) = delete;
+  TimerWheel& operator=(const TimerWheel&) = delete;
+
+  // Set `bits` on `event_group` after `delay` ticks (a delay of 0 expires on the next tick).
+  DataOrError<Timer> Arm(uint32_t delay, EventGroupHandle_t event_group, EventBits_t bits) {
+    Node action = {};
+    action.kind = kEventBits;
+    action.event_group = event_group;
+    action.bits = bits;
+    return Arm_(delay, action);
+  }
+
+  // Call `callback(arg)` after `delay` ticks (a delay of 0 expires on the next tick).
+  DataOrError<Timer> Arm(uint32_t delay, Callback callback, void* arg = nullptr) {
+    Node action = {};
+    action.kind = kCallback;
+    action.callback = callback;
+    action.arg = arg;
+    return Arm_(delay, action);
+  }
+
+  // Move the wheel's time forward to `now`, and expire all timers due.
+  // Returns the number of expired timers. Call from one task only.
+  size_t Advance(uint32_t now) {
+    taskENTER_CRITICAL();
+    uint32_t ticks = now - now_;
+    uint32_t from = now_;
+    now_ = now;
+    taskEXIT_CRITICAL();
+    if (ticks > Slots) ticks = Slots;
+
+    size_t expired = 0;
+    for (uint32_t t = 1; t <= ticks; ++t) {
+      const size_t slot = (from + t) & (Slots - 1);
+      size_t count;
+      do {
+        // Unlink a batch of due timers, run their actions outside of the critical section
+        Node batch[kExpireBatch];
+        count = 0;
+        taskENTER_CRITICAL();
+        for (Index index = slots_[slot]; index != kNone && count < kExpireBatch;) {
+          Node& node = nodes_[index];
+          Index next = node.next;
+          if ((int32_t)(node.deadline - now) <= 0) {
+            Unlink_(index);
+            batch[count++] = node;
+            Free_(index);
+          }
+          index = next;
+        }
+        taskEXIT_CRITICAL();
+        for (size_t i = 0; i < count; ++i) Fire_(batch[i]);
+        expired += count;
+      } while (count == kExpireBatch);
+    }
+    return expired;
+  }
+
+  // Number of ticks until the next tick with timers hashed to it, which is
+  // when `Advance()` should be called next (at the latest). May be early
+  // for timers more than `Slots` ticks out. ESP_ERR_NOT_FOUND if idle.
+  DataOrError<uint32_t> NextWakeup() const {
+    DataOrError<uint32_t> result = ESP_ERR_NOT_FOUND;
+    taskENTER_CRITICAL();
+    for (uint32_t t = 1; t <= Slots; ++t) {
+      if (slots_[(now_ + t) & (Slots - 1)] != kNone) {
+        result = DataOrError<uint32_t>(std::in_place, t);
+        break;
+      }
+    }
+    taskEXIT_CRITICAL();
+    return result;
+  }
+
+  uint32_t now() const { return now_; }
+  size_t active() const { return active_; }
+  static constexpr size_t capacity() { return Capacity; }
+
+ private:
+  enum Kind : uint8_t { kFree, kEventBits, kCallback };
+
+  struct Node {
+    Index next, prev;
+    uint16_t generation;
+    Kind kind;
+    uint32_t deadline;
+    union {
+      EventGroupHandle_t event_group;
+      Callback callback;
+    };
+    union {
+      EventBits_t bits;
+      void* arg;
+    };
+  };
+
+  uint32_t now_;
+  Index free_;
+  size_t active_ = 0;
+  Index slots_[Slots];
+  Node nodes_[Capacity] = {};
+
+  DataOrError<Timer> Arm_(uint32_t delay, const Node& action) {
+    taskENTER_CRITICAL();
+    Index index = free_;
+    if (index == kNone) {
+      taskEXIT_CRITICAL();
+      return ESP_ERR_NO_MEM;
+    }
+    Node& node = nodes_[index];
+    free_ = node.next;
+    uint16_t generation = node.generation;
+    node = action;
+    node.generation = generation;
+    Link_(index, delay);
+    ++active_;
+    taskEXIT_CRITICAL();
+    return Timer(this, index, generation);
+  }
+
+  bool Cancel_(Index index, uint16_t generation) {
+    taskENTER_CRITICAL();
+    bool pending = Pending_(index, generation);
+    if (pending) {
+      Unlink_(index);
+      Free_(index);
+    }
+    taskEXIT_CRITICAL();
+    return pending;
+  }
+
+  bool Rearm_(Index index, uint16_t generation, uint32_t delay) {
+    taskENTER_CRITICAL();
+    bool pending = Pending_(index, generation);
+    if (pending) {
+      Unlink_(index);
+      Link_(index, delay);
+    }
+    taskEXIT_CRITICAL();
+    return pending;
+  }
+
+  bool Pending_(Index index, uint16_t generation) const {
+    const Node& node = nodes_[index];
+    return node.generation == generation && node.kind != kFree;
+  }
+
+  void Link_(Index index, uint32_t delay) {
+    Node& node = nodes_[index];
+    node.deadline = now_ + (delay ? delay : 1);
+    Index& head = slots_[node.deadline & (Slots - 1)];
+    node.prev = kNone;
+    node.next = head;
+    if (head != kNone) nodes_[head].prev = index;
+    head = index;
+  }
+
+  void Unlink_(Index index) {
+    Node& node = nodes_[index];
+    if (node.prev != kNone) {
+      nodes_[node.prev].next = node.next;
+    } else {
+      slots_[node.deadline & (Slots - 1)] = node.next;
+    }
+    if (node.next != kNone) nodes_[node.next].prev = node.prev;
+  }
+
+  void Free_(Index index) {
+    Node& node = nodes_[index];
+    node.kind = kFree;
+    ++node.generation;  // Invalidates outstanding handles
+    node.next = free_;
+    free_ = index;
+    --active_;
+  }
+
+  static void Fire_(const Node& action) {
+    if (action.kind == kEventBits) {
+      xEventGroupSetBits(action.event_group, action.bits);
+    } else {
+      action.callback(action.arg);
+    }
+  }
+};
+
+}  // namespace zw::esp8266::utils
+
+#endif  // ZWUTILS_IDF8266_TIMERWHEEL_H
@@ -0,0 +1,205 @@
+// Compact binary tag-length-value serialization
+
+#ifndef ZWUTILS_IDF8266_TLV_H
+#define ZWUTILS_IDF8266_TLV_H
+
+#include <stdint.h>
+#include <string.h>
+#include <limits>
+#include <string_view>
+#include <type_traits>
+
+#include "esp_err.h"
+
+#include "ZWDataOrError.hpp"
+#include "ZWDataBuf.hpp"
+
+namespace zw::esp8266::utils {
+
+// Each field is encoded as: tag (varint), value length (varint), value bytes.
+// Varints are LEB128 (7 bits per byte, least significant group first).
+// Integer values are varints (zigzag encoded if signed), with zero encoded
+// as an empty value; strings and bytes are raw, nested records are TLV.
+//
+// Since every field carries its length, readers skip unknown tags, so new
+// fields can be added without breaking older readers.
+
+namespace internal {
+
+template <typename T>
+void AppendVarint(DataBuf& out, T val) {
+  for (; val >= 0x80; val >>= 7) out.push_back((uint8_t)(val | 0x80));
+  out.push_back((uint8_t)val);
+}
+
+template <typename T>
+constexpr size_t VarintSize(T val) {
+  size_t size = 1;
+  for (; val >= 0x80; val >>= 7) ++size;
+  return size;
+}
+
+// ESP_ERR_INVALID_SIZE if truncated or overflowing `T`.
+template <typename T>
+DataOrError<T> ConsumeVarint(std::string_view& in) {
+  T val = 0;
+  for (size_t i = 0, shift = 0; i < in.size(); ++i, shift += 7) {
+    T group = (uint8_t)in[i] & 0x7F;
+    if (shift >= sizeof(T) * 8 || (group << shift >> shift) != group) break;
+    val |= group << shift;
+    if (!((uint8_t)in[i] & 0x80)) {
+      in.remove_prefix(i + 1);
+      return DataOrError<T>(std::in_place, val);
+    }
+  }
+  return ESPError{ESP_ERR_INVALID_SIZE};
+}
+
+template <typename T>
+using TlvUInt = std::conditional_t<(sizeof(T) > 4), uint64_t, uint32_t>;
+
+}  // namespace internal
+
+class TlvReader;
+
+// A decoded field, `value` is a view into the encoded buffer.
+struct TlvField {
+  uint32_t tag;
+  std::string_view value;
+
+  // ESP_ERR_INVALID_SIZE if the value does not fit `T`.
+  template <typename T>
+  DataOrError<T> AsInt() const {
+    static_assert(std::is_integral_v<T> && !std::is_same_v<T, bool>);
+    using U = internal::TlvUInt<T>;
+    if (value.empty()) return DataOrError<T>(std::in_place, 0);
+    std::string_view in = value;
+    DataOrError<U> varint = internal::ConsumeVarint<U>(in);
+    if (!varint) return ESPError{varint.error()};
+    U raw = *varint;
+    if (!in.empty()) return ESPError{ESP_ERR_INVALID_SIZE};
+    if constexpr (std::is_signed_v<T>) {
+      auto val = (std::make_signed_t<U>)((raw >> 1) ^ ((U)0 - (raw & 1)));
+      if (val < std::numeric_limits<T>::min() || val > std::numeric_limits<T>::max())
+        return ESPError{ESP_ERR_INVALID_SIZE};
+      return DataOrError<T>(std::in_place, (T)val);
+    } else {
+      if (raw > std::numeric_limits<T>::max()) return ESPError{ESP_ERR_INVALID_SIZE};
+      return DataOrError<T>(std::in_place, (T)raw);
+    }
+  }
+
+  DataOrError<bool> AsBool() const {
+    ASSIGN_OR_RETURN(uint32_t val, AsInt<uint32_t>());
+    return val != 0;
+  }
+
+  const uint8_t* data() const { return (const uint8_t*)value.data(); }
+  size_t size() const { return value.size(); }
+
+  // Reader of a nested record.
+  inline TlvReader AsTlv() const;
+};
+
+// Encodes fields by appending to a `DataBuf`.
+//   TlvWriter writer(buf);
+//   writer.Put(kSsid, ssid).PutInt(kPort, port);
+class TlvWriter {
+ public:
+  explicit TlvWriter(DataBuf& out) : out_(out) {}
+
+  TlvWriter& Put(uint32_t tag, const void* data, size_t len) {
+    internal::AppendVarint(out_, tag);
+    internal::AppendVarint(out_, len);
+    out_.insert(out_.end(), (const uint8_t*)data, (const uint8_t*)data + len);
+    return *this;
+  }
+  TlvWriter& Put(uint32_t tag, std::string_view str) { return Put(tag, str.data(), str.size()); }
+  TlvWriter& Put(uint32_t tag, const DataBuf& buf) { return Put(tag, buf.data(), buf.size()); }
+
+  template <typename T>
+  TlvWriter& PutInt(uint32_t tag, T val) {
+    static_assert(std::is_integral_v<T> && !std::is_same_v<T, bool>);
+    using U = internal::TlvUInt<T>;
+    U raw = (U)val;
+    if constexpr (std::is_signed_v<T>) raw = (raw << 1) ^ ((U)0 - (raw >> (sizeof(U) * 8 - 1)));
+    internal::AppendVarint(out_, tag);
+    if (raw == 0) {
+      out_.push_back(0);
+    } else {
+      internal::AppendVarint(out_, internal::VarintSize(raw));
+      internal::AppendVarint(out_, raw);
+    }
+    return *this;
+  }
+  TlvWriter& PutBool(uint32_t tag, bool val) { return PutInt<uint8_t>(tag, val); }
+
+  // Nested record, fields written until the matching `EndNested()` belong to it.
+  //   size_t nested = writer.BeginNested(kWifi);
+  //   writer.Put(kSsid, ssid);
+  //   writer.EndNested(nested);
+  size_t BeginNested(uint32_t tag) {
+    internal::AppendVarint(out_, tag);
+    out_.push_back(0);  // Length placeholder, assuming it fits one byte
+    return out_.size();
+  }
+  void EndNested(size_t begin) {
+    size_t len = out_.size() - begin;
+    size_t len_size = internal::VarintSize(len);
+    if (len_size > 1) out_.insert(out_.begin() + begin, len_size - 1, 0);
+    uint8_t* ptr = out_.data() + begin - 1;
+    for (; len >= 0x80; len >>= 7) *ptr++ = (uint8_t)(len | 0x80);
+    *ptr = (uint8_t)len;
+  }
+
+ private:
+  DataBuf& out_;
+};
+
+// Decodes fields without copying, returned values are views into the input,
+// which must outlive them.
+//   TlvReader reader(buf);
+//   while (!reader.done()) {
+//     ASSIGN_OR_RETURN(TlvField field, reader.Next());
+//     switch (field.tag) {
+//       case kPort: ASSIGN_OR_RETURN(port, field.AsInt<uint16_t>()); break;
+//       default: break;  // Unknown field, skipped
+//     }
+//   }
+class TlvReader {
+ public:
+  explicit TlvReader(std::string_view data) : data_(data) {}
+  explicit TlvReader(const DataBuf& buf) : data_((const char*)buf.data(), buf.size()) {}
+
+  bool done() const { return data_.empty(); }
+
+  // ESP_ERR_NOT_FOUND at the end, ESP_ERR_INVALID_SIZE if the data is truncated.
+  DataOrError<TlvField> Next() {
+    if (data_.empty()) return ESP_ERR_NOT_FOUND;
+    std::string_view in = data_;
+    ASSIGN_OR_RETURN(uint32_t tag, internal::ConsumeVarint<uint32_t>(in));
+    ASSIGN_OR_RETURN(uint32_t len, internal::ConsumeVarint<uint32_t>(in));
+    if (len > in.size()) return ESP_ERR_INVALID_SIZE;
+    data_ = in.substr(len);
+    return TlvField{tag, in.substr(0, len)};
+  }
+
+  // Find the first field with `tag` among the remaining ones, without
+  // consuming any. ESP_ERR_NOT_FOUND if there is none.
+  DataOrError<TlvField> Find(uint32_t tag) const {
+    TlvReader reader = *this;
+    while (true) {
+      ASSIGN_OR_RETURN(TlvField field, reader.Next());
+      if (field.tag == tag) return field;
+    }
+  }
+
+ private:
+  std::string_view data_;
+};
+
+inline TlvReader TlvField::AsTlv() const { return TlvReader(value); }
+
+}  // namespace zw::esp8266::utils
+
+#endif  // ZWUTILS_IDF8266_TLV_H
@@ -0,0 +1,277 @@
+// Low-overhead scoped trace events
+
+#ifndef ZWUTILS_IDF8266_TRACE_H
+#define ZWUTILS_IDF8266_TRACE_H
+
+#include <stdint.h>
+#include <string.h>
+#include <algorithm>
+#include <atomic>
+#include <string_view>
+#include <vector>
+
+#include "esp_err.h"
+#include "esp_timer.h"
+
+#include "FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "ZWMacros.h"
+#include "ZWDataBuf.hpp"
+#include "ZWStrCat.hpp"
+
+// Tracing is compiled in only if `ZW_TRACE_ENABLE` is defined; otherwise the
+// macros expand to nothing, and no trace buffers are allocated.
+//
+// Tunables (define before including):
+// - `ZW_TRACE_MAX_TASKS`: number of tasks that can record events (default 4).
+// - `ZW_TRACE_BUFFER_EVENTS`: ring buffer capacity per task, power of 2 (default 64).
+// - `ZW_TRACE_CLOCK()`: 32-bit microsecond timestamp source.
+// - `ZW_TRACE_TLS_INDEX`: FreeRTOS thread-local storage pointer index used to
+//   cache each task's ring (default: the last one). Must not be used by anything
+//   else, increase `CONFIG_FREERTOS_THREAD_LOCAL_STORAGE_POINTERS` if needed.
+
+#ifndef ZW_TRACE_MAX_TASKS
+#define ZW_TRACE_MAX_TASKS 4
+#endif
+
+#ifndef ZW_TRACE_BUFFER_EVENTS
+#define ZW_TRACE_BUFFER_EVENTS 64
+#endif
+
+#ifndef ZW_TRACE_CLOCK
+#define ZW_TRACE_CLOCK() ((uint32_t)esp_timer_get_time())
+#endif
+
+#ifndef ZW_TRACE_TLS_INDEX
+#define ZW_TRACE_TLS_INDEX (configNUM_THREAD_LOCAL_STORAGE_POINTERS - 1)
+#endif
+
+namespace zw::esp8266::utils {
+
+struct TraceEvent {
+  enum Type : uint8_t { kComplete, kCounter };
+
+  const char* name;  // Must have static storage duration
+  uint32_t timestamp;
+  int32_t arg;  // Duration for kComplete, value for kCounter
+  Type type;
+};
+
+#ifdef ZW_TRACE_ENABLE
+
+namespace internal {
+
+static_assert((ZW_TRACE_BUFFER_EVENTS & (ZW_TRACE_BUFFER_EVENTS - 1)) == 0,
+              "ZW_TRACE_BUFFER_EVENTS must be a power of 2");
+static_assert(ZW_TRACE_TLS_INDEX >= 0 &&
+                  ZW_TRACE_TLS_INDEX < configNUM_THREAD_LOCAL_STORAGE_POINTERS,
+              "ZW_TRACE_TLS_INDEX out of range");
+
+// Single-producer ring, only written by the owning task, so recording needs
+// no lock and no atomic read-modify-write (which this core does not have).
+struct TraceRing {
+  std::atomic<TaskHandle_t> owner;
+  char task_name[configMAX_TASK_NAME_LEN];
+  std::atomic<uint32_t> head;  // Total number of events recorded
+  TraceEvent events[ZW_TRACE_BUFFER_EVENTS];
+
+  void Record(const char* name, uint32_t timestamp, int32_t arg, TraceEvent::Type type) {
+    uint32_t pos = head.load(std::memory_order_relaxed);
+    events[pos & (ZW_TRACE_BUFFER_EVENTS - 1)] = {name, timestamp, arg, type};
+    head.store(pos + 1, std::memory_order_release);
+  }
+};
+
+inline TraceRing trace_rings[ZW_TRACE_MAX_TASKS] = {};
+inline std::atomic<uint32_t> trace_dropped = 0;
+
+// Returns nullptr if another task claimed the last free ring meanwhile.
+inline TraceRing* TraceClaimRing(TaskHandle_t task) {
+  TraceRing* result = nullptr;
+  taskENTER_CRITICAL();
+  for (TraceRing& ring : trace_rings) {
+    if (ring.owner.load(std::memory_order_relaxed) == nullptr) {
+      result = &ring;
+      break;
+    }
+  }
+  if (result != nullptr) {
+    result->head.store(0, std::memory_order_relaxed);  // Drop a previous owner's events
+    strncpy(result->task_name, pcTaskGetTaskName(task), sizeof(result->task_name) - 1);
+    result->owner.store(task, std::memory_order_release);
+  }
+  taskEXIT_CRITICAL();
+  return result;
+}
+
+inline TraceRing* TraceCurrentRing() {
+  TaskHandle_t task = xTaskGetCurrentTaskHandle();
+  // The cached ring may be stale if it was released or reset meanwhile
+  auto* cached = (TraceRing*)pvTaskGetThreadLocalStoragePointer(nullptr, ZW_TRACE_TLS_INDEX);
+  if (cached != nullptr && cached->owner.load(std::memory_order_relaxed) == task) return cached;
+
+  bool any_free = false;
+  for (TraceRing& ring : trace_rings) {
+    any_free |= ring.owner.load(std::memory_order_relaxed) == nullptr;
+  }
+  // Only lock if there is a ring to claim, so tasks left out stay cheap
+  TraceRing* result = any_free ? TraceClaimRing(task) : nullptr;
+  if (result == nullptr) {
+    // No atomic increment on this core, the count may be off under contention
+    trace_dropped.store(trace_dropped.load(std::memory_order_relaxed) + 1,
+                        std::memory_order_relaxed);
+  }
+  vTaskSetThreadLocalStoragePointer(nullptr, ZW_TRACE_TLS_INDEX, result);
+  return result;
+}
+
+inline void TraceRecord(const char* name, uint32_t timestamp, int32_t arg,
+                        TraceEvent::Type type) {
+  TraceRing* ring = TraceCurrentRing();
+  if (ring != nullptr) ring->Record(name, timestamp, arg, type);
+}
+
+// Append `str` as JSON string contents, escaping quotes, backslashes and
+// control characters.
+inline void TraceAppendEscaped(DataBuf& out, std::string_view str) {
+  static constexpr char kHexDigits[] = "0123456789abcdef";
+  size_t start = 0;
+  for (size_t i = 0; i < str.size(); ++i) {
+    unsigned char c = str[i];
+    if (c >= 0x20 && c != '"' && c != '\\') continue;
+    StrAppend(out, str.substr(start, i - start));
+    if (c >= 0x20) {
+      StrAppend(out, '\\', (char)c);
+    } else {
+      StrAppend(out, "\\u00", kHexDigits[c >> 4], kHexDigits[c & 0xF]);
+    }
+    start = i + 1;
+  }
+  StrAppend(out, str.substr(start));
+}
+
+}  // namespace internal
+
+// Records a complete event spanning its lifetime, see `ZW_TRACE_SCOPE()`.
+class TraceScope {
+  using _class = TraceScope;
+
+ public:
+  TraceScope(const char* name) : name_(name), start_(ZW_TRACE_CLOCK()) {}
+  ~TraceScope() {
+    internal::TraceRecord(name_, start_, ZW_TRACE_CLOCK() - start_, TraceEvent::kComplete);
+  }
+
+  TraceScope(const _class&) = delete;
+  TraceScope& operator=(const _class&) = delete;
+
+ private:
+  const char* name_;
+  uint32_t start_;
+};
+
+inline void TraceCounter(const char* name, int32_t value) {
+  internal::TraceRecord(name, ZW_TRACE_CLOCK(), value, TraceEvent::kCounter);
+}
+
+// Number of events dropped because all task slots were taken (approximate).
+inline uint32_t TraceDropped() { return internal::trace_dropped.load(std::memory_order_relaxed); }
+
+// Release the calling task's slot and discard its events, so it can be reused.
+// Call before a traced task deletes itself, e.g. `TraceReleaseRing(); vTaskDelete(NULL);`,
+// otherwise short-lived tasks eventually take all `ZW_TRACE_MAX_TASKS` slots.
+inline void TraceReleaseRing() {
+  auto* ring =
+      (internal::TraceRing*)pvTaskGetThreadLocalStoragePointer(nullptr, ZW_TRACE_TLS_INDEX);
+  if (ring == nullptr) return;
+  vTaskSetThreadLocalStoragePointer(nullptr, ZW_TRACE_TLS_INDEX, nullptr);
+  if (ring->owner.load(std::memory_order_relaxed) == xTaskGetCurrentTaskHandle()) {
+    ring->owner.store(nullptr, std::memory_order_release);
+  }
+}
+
+// Discard recorded events and release task slots.
+// Must not race with recording, e.g. call before starting the traced tasks.
+inline void TraceReset() {
+  for (internal::TraceRing& ring : internal::trace_rings) {
+    ring.owner.store(nullptr, std::memory_order_relaxed);
+    memset(ring.task_name, 0, sizeof(ring.task_name));
+    ring.head.store(0, std::memory_order_relaxed);
+  }
+  internal::trace_dropped.store(0, std::memory_order_relaxed);
+}
+
+// Append recorded events as Chrome trace-event JSON (load it in `chrome://tracing`
+// or https://ui.perfetto.dev). Safe to call while other tasks are recording:
+// events possibly overwritten during the dump are left out.
+inline void TraceDump(DataBuf& out) {
+  StrAppend(out, "{\"traceEvents\":[");
+  bool first = true;
+  for (size_t tid = 0; tid < ZW_TRACE_MAX_TASKS; ++tid) {
+    const internal::TraceRing& ring = internal::trace_rings[tid];
+    if (ring.owner.load(std::memory_order_acquire) == nullptr) continue;
+
+    StrAppend(out, first ? "" : ",", "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":",
+              tid, ",\"args\":{\"name\":\"");
+    internal::TraceAppendEscaped(out, ring.task_name);
+    StrAppend(out, "\"}}");
+    first = false;
+
+    // Snapshot first, the owning task may preempt us and keep recording
+    const uint32_t kCapacity = ZW_TRACE_BUFFER_EVENTS;
+    uint32_t head = ring.head.load(std::memory_order_acquire);
+    uint32_t count = std::min(head, kCapacity);
+    std::vector<TraceEvent> events(count);
+    for (uint32_t i = 0; i < count; ++i) {
+      events[i] = ring.events[(head - count + i) & (kCapacity - 1)];
+    }
+    // The oldest events may have been overwritten while copying (including
+    // the one possibly being written right now), leave them out.
+    uint32_t new_head = ring.head.load(std::memory_order_acquire);
+    uint32_t overwritten = std::min(new_head - head + 1, kCapacity);
+    uint32_t skip = count + overwritten > kCapacity ? count + overwritten - kCapacity : 0;
+
+    for (uint32_t i = skip; i < count; ++i) {
+      const TraceEvent& event = events[i];
+      StrAppend(out, ",{\"name\":\"");
+      internal::TraceAppendEscaped(out, event.name);
+      StrAppend(out, "\",\"pid\":1,\"tid\":", tid, ",\"ts\":", event.timestamp);
+      if (event.type == TraceEvent::kComplete) {
+        StrAppend(out, ",\"ph\":\"X\",\"dur\":", event.arg, "}");
+      } else {
+        StrAppend(out, ",\"ph\":\"C\",\"args\":{\"value\":", event.arg, "}}");
+      }
+    }
+  }
+  StrAppend(out, "]}");
+}
+
+// Record the enclosing scope as a complete event, `name` must be a string literal.
+#define ZW_TRACE_SCOPE(name) \
+  ::zw::esp8266::utils::TraceScope ZW_UNIQUE_VAR(trace_scope)(name)
+
+// Record a counter sample, `name` must be a string literal.
+#define ZW_TRACE_COUNTER(name, value) ::zw::esp8266::utils::TraceCounter(name, value)
+
+#else
+
+// Distinct from the enabled definitions, so translation units built with and
+// without `ZW_TRACE_ENABLE` can be linked together.
+inline namespace trace_disabled {
+
+inline uint32_t TraceDropped() { return 0; }
+inline void TraceReleaseRing() {}
+inline void TraceReset() {}
+inline void TraceDump(DataBuf& out) { StrAppend(out, "{\"traceEvents\":[]}"); }
+
+}  // namespace trace_disabled
+
+#define ZW_TRACE_SCOPE(name)
+#define ZW_TRACE_COUNTER(name, value) ((void)0)
+
+#endif  // ZW_TRACE_ENABLE
+
+}  // namespace zw::esp8266::utils
+
+#endif  // ZWUTILS_IDF8266_TRACE_H
@@ -2,8 +2,18 @@
 
 #include "ZW_IDFLTH.h"
 #include "ZWStrings.hpp"
+#include "ZWStrCat.hpp"
 #include "ZWMacros.h"
 #include "ZWAutoRelease.hpp"
 #include "ZWDataOrError.hpp"
 #include "ZWParsers.hpp"
+#include "ZWFormatters.hpp"
+#include "ZWCodecs.hpp"
+#include "ZWJsonTokenizer.hpp"
 #include "ZWDataBuf.hpp"
+#include "ZWChecksums.hpp"
+#include "ZWTrace.hpp"
+#include "ZWBinLog.hpp"
+#include "ZWTimerWheel.hpp"
+#include "ZWCompression.hpp"
+#include "ZWTlv.hpp"
@@ -6,6 +6,17 @@
 
 // Assume #include "esp_err.h"
 // Assume #include "esp_log.h" if NDEBUG is not defined
+// Assume #include "ZWBinLog.hpp" if ZW_BINLOG_ENABLE is defined
+
+#ifndef NDEBUG
+#ifdef ZW_BINLOG_ENABLE
+#define ZW_LOG_ESP_ERROR(err) \
+  ZW_BINLOGD(TAG, "ESP Error (%s:%d) %d (0x%x)", __FILE__, __LINE__, err, err)
+#else
+#define ZW_LOG_ESP_ERROR(err) \
+  ESP_LOGD(TAG, "ESP Error (%s:%d) %d (0x%x)", __FILE__, __LINE__, err, err)
+#endif  // ZW_BINLOG_ENABLE
+#endif  // NDEBUG
 
 #ifdef NDEBUG
 #define ESP_RETURN_ON_ERROR(x) \
@@ -16,13 +27,13 @@
     }                          \
   } while (0)
 #else
-#define ESP_RETURN_ON_ERROR(x)                                                              \
-  do {                                                                                      \
-    esp_err_t __err_rc = (x);                                                               \
-    if (__err_rc != ESP_OK) {                                                               \
-      ESP_LOGD(TAG, "ESP Error (%s:%d) %d (0x%x)", __FILE__, __LINE__, __err_rc, __err_rc); \
-      return __err_rc;                                                                      \
-    }                                                                                       \
+#define ESP_RETURN_ON_ERROR(x)    \
+  do {                            \
+    esp_err_t __err_rc = (x);     \
+    if (__err_rc != ESP_OK) {     \
+      ZW_LOG_ESP_ERROR(__err_rc); \
+      return __err_rc;            \
+    }                             \
   } while (0)
 #endif  // NDEBUG
 
@@ -35,13 +46,13 @@
     }                                  \
   } while (0)
 #else
-#define ESP_GOTO_ON_ERROR(x, goto_tag)                                                      \
-  do {                                                                                      \
-    esp_err_t __err_rc = (x);                                                               \
-    if (__err_rc != ESP_OK) {                                                               \
-      ESP_LOGD(TAG, "ESP Error (%s:%d) %d (0x%x)", __FILE__, __LINE__, __err_rc, __err_rc); \
-      goto goto_tag;                                                                        \
-    }                                                                                       \
+#define ESP_GOTO_ON_ERROR(x, goto_tag) \
+  do {                                 \
+    esp_err_t __err_rc = (x);          \
+    if (__err_rc != ESP_OK) {          \
+      ZW_LOG_ESP_ERROR(__err_rc);      \
+      goto goto_tag;                   \
+    }                                  \
   } while (0)
 #endif  // NDEBUG
 
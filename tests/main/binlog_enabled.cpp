@@ -0,0 +1,25 @@
+// Error logging of the macros routed to the binary log, linked into the test program
+
+// Compile in debug logging, which includes the error logging of the macros
+#define LOG_LOCAL_LEVEL ESP_LOG_DEBUG
+#define ZW_BINLOG_ENABLE
+
+#include "esp_err.h"
+#include "esp_log.h"
+
+#include "ZWBinLog.hpp"
+#include "ZW_IDFLTH.h"
+
+namespace zw::esp8266::utils::testing {
+namespace {
+
+inline constexpr char TAG[] = "BinLog";
+
+}  // namespace
+
+esp_err_t BinLogEnabledFailing() {
+  ESP_RETURN_ON_ERROR(ESP_ERR_INVALID_STATE);
+  return ESP_OK;
+}
+
+}  // namespace zw::esp8266::utils::testing
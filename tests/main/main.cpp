@@ -1,10 +1,13 @@
 
 #include <stddef.h>
+#include <stdlib.h>
 #include <string.h>
+#include <map>
 #include <optional>
 
 #include "esp_err.h"
 #include "esp_log.h"
+#include "esp_timer.h"
 
 #include "FreeRTOS.h"
 #include "freertos/event_groups.h"
@@ -13,6 +16,14 @@
 #include "ZWUtils.hpp"
 
 namespace zw::esp8266::utils::testing {
+
+// Records a scope and a counter with tracing compiled out, and dumps the trace.
+void TraceDisabledDump(DataBuf& out);
+
+// Fails with ESP_RETURN_ON_ERROR(ESP_ERR_INVALID_STATE), with the error logging
+// routed to the binary log at debug level.
+esp_err_t BinLogEnabledFailing();
+
 namespace {
 
 inline constexpr char TAG[] = "Main";
@@ -42,6 +53,19 @@ size_t failed_count = 0;
     ESP_LOGI(TAG, "[%s] %-25s case #%02d ... %s", prefix, __func__, case_num, verdict); \
   }
 
+// Report the average time per iteration of `expr`, which can use the iteration
+// index `bench_i`. Results need to be written to a volatile sink to avoid being
+// optimized out.
+#define BENCH_RUN(label, iterations, expr)                                                 \
+  {                                                                                        \
+    int64_t start = esp_timer_get_time();                                                  \
+    for (int bench_i = 0; bench_i < (iterations); ++bench_i) {                             \
+      expr;                                                                                \
+    }                                                                                      \
+    int64_t elapsed = esp_timer_get_time() - start;                                        \
+    ESP_LOGI(TAG, "[Bench] %-32s %6d ns/op", label, (int)(elapsed * 1000 / (iterations))); \
+  }
+
 esp_err_t _test_ZWStrings() {
   TEST_RUN(STRLEN("12345") == 5);
   TEST_RUN(STRLEN("") == 0);
@@ -51,6 +75,154 @@ esp_err_t _test_ZWStrings() {
   TEST_RUN(PasswordRedact("ae") == "ae");
   TEST_RUN(PasswordRedact("a") == "a");
   TEST_RUN(PasswordRedact("") == "");
+  TEST_RUN(PasswordRedact<8>("abcde") == "a***e");
+  TEST_RUN(PasswordRedact<8>("a") == "a");
+  TEST_RUN(PasswordRedact<8>("") == "");
+  TEST_RUN(PasswordRedact<4>("abcdefg") == "a**g");
+
+  {
+    InlineString<8> str("abc");
+    TEST_RUN(str.size() == 3 && str == "abc" && strcmp(str.c_str(), "abc") == 0);
+    str += "de";
+    str += 'f';
+    TEST_RUN(str == std::string("abcdef"));
+    TEST_RUN(str.find("cd") == 2 && str.find('z') == str.npos);
+    TEST_RUN(str.substr(1, 3) == "bcd");
+    str.append("ghijk");
+    TEST_RUN(str.full() && str == "abcdefgh" && str.c_str()[8] == '\0');
+    str.resize(2);
+    TEST_RUN(str == "ab" && str < "b" && str != "abc");
+    str.clear();
+    TEST_RUN(str.empty() && str.c_str()[0] == '\0');
+    static_assert(InlineString<4>("abcdef") == "abcd");
+  }
+
+  TEST_RUN(StrCat() == "");
+  TEST_RUN(StrCat("http://", std::string("host"), ':', 8080, std::string_view("/path")) ==
+           "http://host:8080/path");
+  TEST_RUN(StrCat(-12, '/', (uint8_t)200, '/', 1.5, '/', InlineString<4>("ab")) ==
+           "-12/200/1.500000/ab");
+  {
+    std::string str = "a";
+    StrAppend(str, "b", 'c', 1);
+    TEST_RUN(str == "abc1");
+    DataBuf buf;
+    StrAppend(buf, "key=", 42);
+    TEST_RUN(std::string_view((char*)buf.data(), buf.size()) == "key=42");
+    // Appending in a loop must not reallocate every time
+    size_t reallocs = 0;
+    for (int i = 0; i < 1000; ++i) {
+      const uint8_t* before = buf.data();
+      StrAppend(buf, "abcdefgh");
+      reallocs += buf.data() != before;
+    }
+    TEST_RUN(buf.size() == 6 + 8000);
+    TEST_ASSERT(reallocs < 20);
+  }
+
+  static_assert("Content-Type"_strhash == StrHash("Content-Type"));
+  TEST_RUN(StrHash(std::string("Content-Type")) == "Content-Type"_strhash);
+  TEST_RUN(StrHash("abc", 1) != StrHash("abc"));
+  // Known FNV-1a collision, only key-compared lookups tell them apart
+  static_assert("costarring"_strhash == "liquid"_strhash);
+  {
+    static constexpr auto kWords = MakeStringMap<int>({{"costarring", 1}, {"other", 2}});
+    TEST_RUN(kWords.Get("liquid", 0) == 0);
+    TEST_RUN(kWords.Get("costarring", 0) == 1);
+  }
+
+  {
+    enum class Method { kUnknown, kGet, kPost, kPut, kDelete };
+    static constexpr auto kMethods = MakeStringMap<Method>({
+        {"GET", Method::kGet},
+        {"POST", Method::kPost},
+        {"PUT", Method::kPut},
+        {"DELETE", Method::kDelete},
+    });
+    static_assert(kMethods.size() == 4);
+    static_assert(kMethods.Get("POST", Method::kUnknown) == Method::kPost);
+    static_assert(!kMethods.Contains("PATCH"));
+    TEST_RUN(*kMethods.Find(std::string("GET")) == Method::kGet);
+    TEST_RUN(kMethods.Get("DELETE", Method::kUnknown) == Method::kDelete);
+    TEST_RUN(kMethods.Get("get", Method::kUnknown) == Method::kUnknown);
+    TEST_RUN(kMethods.Find("") == nullptr);
+    TEST_RUN(kMethods.Find("GETX") == nullptr);
+  }
+  {
+    static constexpr auto kEmptyKey = MakeStringMap<int>({{"", 1}, {"a", 2}});
+    TEST_RUN(kEmptyKey.Get("", 0) == 1);
+    TEST_RUN(kEmptyKey.Get("a", 0) == 2);
+    TEST_RUN(kEmptyKey.Get("b", 0) == 0);
+  }
+
+  return ESP_OK;
+}
+
+// Synthetic keys for benchmarking with large key sets
+template <size_t N>
+struct BenchKeys {
+  char storage[N][8] = {};
+  std::array<std::pair<std::string_view, int>, N> items = {};
+
+  constexpr BenchKeys() {
+    for (size_t i = 0; i < N; ++i) {
+      const char prefix[] = "x-hdr-";
+      for (size_t k = 0; k < 6; ++k) storage[i][k] = prefix[k];
+      storage[i][6] = 'a' + i / 26 % 26;
+      storage[i][7] = 'a' + i % 26;
+      // `std::pair` assignment is not constexpr until C++20
+      items[i].first = {storage[i], 8};
+      items[i].second = (int)i;
+    }
+  }
+};
+
+template <size_t N>
+esp_err_t _bench_StringMap(const char* const (&labels)[3]) {
+  static constexpr BenchKeys<N> kKeys;
+  static constexpr auto kMap = MakeStringMap(kKeys.items);
+  std::map<std::string_view, int> std_map(kKeys.items.begin(), kKeys.items.end());
+  std::array<std::string, N> queries;
+  for (size_t i = 0; i < N; ++i) queries[i] = std::string(kKeys.items[i].first);
+  [[maybe_unused]] volatile int sink;
+
+  for (size_t i = 0; i < N; ++i) TEST_ASSERT(kMap.Get(queries[i], -1) == (int)i);
+
+  auto strcmp_chain = [&](const std::string& query) {
+    for (size_t i = 0; i < N; ++i)
+      if (strncmp(query.c_str(), kKeys.storage[i], 8) == 0) return (int)i;
+    return -1;
+  };
+
+  BENCH_RUN(labels[0], 1000, sink = kMap.Get(queries[bench_i % N], -1));
+  BENCH_RUN(labels[1], 1000, sink = strcmp_chain(queries[bench_i % N]));
+  BENCH_RUN(labels[2], 1000, sink = std_map.find(queries[bench_i % N])->second);
+
+  return ESP_OK;
+}
+
+esp_err_t _bench_ZWStrings() {
+  const std::string host = "example.com", path = "/api/v1/status";
+  [[maybe_unused]] volatile size_t sink;
+
+  BENCH_RUN("std::string operator+", 1000,
+            sink = (std::string("http://") + host + ":" + std::to_string(8080) + path).size());
+  BENCH_RUN("StrCat", 1000, sink = StrCat("http://", host, ':', 8080, path).size());
+  BENCH_RUN("InlineString", 1000, {
+    InlineString<64> url("http://");
+    url += host;
+    url += ':';
+    url += "8080";
+    url += path;
+    sink = url.size();
+  });
+
+  if (_bench_StringMap<10>({"StringMap (10 keys)", "strcmp chain (10 keys)",
+                            "std::map (10 keys)"}) != ESP_OK)
+    return ESP_FAIL;
+  if (_bench_StringMap<100>({"StringMap (100 keys)", "strcmp chain (100 keys)",
+                             "std::map (100 keys)"}) != ESP_OK)
+    return ESP_FAIL;
 
   return ESP_OK;
 }
@@ -250,6 +422,18 @@ esp_err_t _test_ZWDataOrError() {
     TEST_RUN(*Test == "OK");
     TEST_RUN(Test->length() == 2);
   }
+  {
+    uint32_t v = 7;
+    DataOrError<uint32_t> Test = v;
+    TEST_ASSERT(Test && *Test == 7);
+  }
+  {
+    static_assert(!std::is_convertible_v<esp_err_t, DataOrError<esp_err_t>>);
+    DataOrError<esp_err_t> Test(std::in_place, ESP_ERR_TIMEOUT);
+    TEST_RUN(Test && *Test == ESP_ERR_TIMEOUT);
+    Test = ESPError{ESP_ERR_NO_MEM};
+    TEST_RUN(Test.error() == ESP_ERR_NO_MEM);
+  }
 
   {
     TEST_RUN([] {
@@ -298,6 +482,1008 @@ esp_err_t _test_ZWParsers() {
   TEST_RUN(IS_OK_AND_VALUE(UrlDecode("a%62%63"), == "abc"));
   TEST_RUN(!UrlDecode("%x"));
 
+  TEST_RUN(IS_OK_AND_VALUE(ParseInt<int32_t>("0"), == 0));
+  TEST_RUN(IS_OK_AND_VALUE(ParseInt<int32_t>("2147483647"), == 2147483647));
+  TEST_RUN(IS_OK_AND_VALUE(ParseInt<int32_t>("-2147483648"), == INT32_MIN));
+  TEST_RUN(ParseInt<int32_t>("2147483648").error() == ESP_ERR_INVALID_SIZE);
+  TEST_RUN(IS_OK_AND_VALUE(ParseInt<uint64_t>("18446744073709551615"), == UINT64_MAX));
+  TEST_RUN(ParseInt<uint64_t>("18446744073709551616").error() == ESP_ERR_INVALID_SIZE);
+  TEST_RUN(IS_OK_AND_VALUE(ParseInt<int32_t>("-123"), == -123));
+  TEST_RUN(IS_OK_AND_VALUE(ParseInt<int8_t>("-128"), == -128));
+  TEST_RUN(ParseInt<int8_t>("128").error() == ESP_ERR_INVALID_SIZE);
+  TEST_RUN(IS_OK_AND_VALUE(ParseInt<uint16_t>("65535"), == 65535));
+  TEST_RUN(ParseInt<uint16_t>("65536").error() == ESP_ERR_INVALID_SIZE);
+  TEST_RUN(ParseInt<uint16_t>("-1").error() == ESP_ERR_INVALID_ARG);
+  TEST_RUN(ParseInt<int32_t>("").error() == ESP_ERR_INVALID_ARG);
+  TEST_RUN(ParseInt<int32_t>("12a").error() == ESP_ERR_INVALID_ARG);
+  TEST_RUN(ParseInt<int32_t>("-").error() == ESP_ERR_INVALID_ARG);
+
+  {
+    std::string_view in = "123,-45";
+    TEST_RUN(IS_OK_AND_VALUE(ConsumeInt<int16_t>(in), == 123));
+    TEST_RUN(in == ",-45");
+    TEST_RUN(!ConsumeInt<int16_t>(in));
+    TEST_RUN(in == ",-45");
+  }
+
+  TEST_RUN(IS_OK_AND_VALUE((ParseFixed<int32_t, 2>("12.34")), == 1234));
+  TEST_RUN(IS_OK_AND_VALUE((ParseFixed<int32_t, 2>("-0.5")), == -50));
+  TEST_RUN(IS_OK_AND_VALUE((ParseFixed<int32_t, 2>("7")), == 700));
+  TEST_RUN(IS_OK_AND_VALUE((ParseFixed<int32_t, 2>(".999")), == 99));
+  TEST_RUN(IS_OK_AND_VALUE((ParseFixed<uint8_t, 1>("25.5")), == 255));
+  TEST_RUN((ParseFixed<uint8_t, 1>("25.6").error() == ESP_ERR_INVALID_SIZE));
+  TEST_RUN((ParseFixed<int32_t, 2>(".").error() == ESP_ERR_INVALID_ARG));
+
+  TEST_RUN(IS_OK_AND_VALUE(ParseFloat<double>("0"), == 0.0));
+  TEST_RUN(IS_OK_AND_VALUE(ParseFloat<double>("-1.25"), == -1.25));
+  TEST_RUN(IS_OK_AND_VALUE(ParseFloat<double>("3.14159"), == 3.14159));
+  TEST_RUN(IS_OK_AND_VALUE(ParseFloat<double>("1e-3"), == 0.001));
+  TEST_RUN(IS_OK_AND_VALUE(ParseFloat<double>("+2.5E+3"), == 2500.0));
+  TEST_RUN(IS_OK_AND_VALUE(ParseFloat<float>("0.1"), == 0.1f));
+  TEST_RUN(IS_OK_AND_VALUE(ParseFloat<double>("1e-400"), == 0.0));
+  TEST_RUN(ParseFloat<float>("1e39").error() == ESP_ERR_INVALID_SIZE);
+  TEST_RUN(ParseFloat<double>("1e99999").error() == ESP_ERR_INVALID_SIZE);
+  TEST_RUN(ParseFloat<double>("e5").error() == ESP_ERR_INVALID_ARG);
+  TEST_RUN(ParseFloat<double>("1e+-5").error() == ESP_ERR_INVALID_ARG);
+  TEST_RUN(ParseFloat<double>("1e-+5").error() == ESP_ERR_INVALID_ARG);
+  TEST_RUN(ParseFloat<double>("1e--5").error() == ESP_ERR_INVALID_ARG);
+  TEST_RUN(IS_OK_AND_VALUE(ParseFloat<double>("1e-99999"), == 0.0));
+  {
+    std::string_view in = "1.5e";
+    TEST_RUN(IS_OK_AND_VALUE(ConsumeFloat<double>(in), == 1.5));
+    TEST_RUN(in == "e");
+  }
+
+  return ESP_OK;
+}
+
+esp_err_t _test_ZWFormatters() {
+  char buf[kMaxFloatChars];
+  auto format = [&](DataOrError<size_t>&& len) {
+    return len ? std::string(buf, *len) : std::string("<error>");
+  };
+
+  TEST_RUN(format(FormatInt(buf, sizeof(buf), 0)) == "0");
+  TEST_RUN(format(FormatInt(buf, sizeof(buf), -123)) == "-123");
+  TEST_RUN(format(FormatInt(buf, sizeof(buf), INT32_MIN)) == "-2147483648");
+  TEST_RUN(format(FormatInt(buf, sizeof(buf), (int8_t)-128)) == "-128");
+  TEST_RUN(format(FormatInt(buf, sizeof(buf), UINT64_MAX)) == "18446744073709551615");
+  TEST_RUN(format(FormatInt(buf, sizeof(buf), INT64_MIN)) == "-9223372036854775808");
+  TEST_RUN(format(FormatInt(buf, sizeof(buf), 1000000000000ULL)) == "1000000000000");
+  TEST_RUN(FormatInt(buf, 3, 1234).error() == ESP_ERR_INVALID_SIZE);
+
+  TEST_RUN(format(FormatFixed<int32_t, 2>(buf, sizeof(buf), -1234)) == "-12.34");
+  TEST_RUN(format(FormatFixed<int32_t, 3>(buf, sizeof(buf), 5)) == "0.005");
+  TEST_RUN(format(FormatFixed<uint16_t, 0>(buf, sizeof(buf), 42)) == "42");
+
+  TEST_RUN(format(FormatFloat(buf, sizeof(buf), 0.0)) == "0.000000");
+  TEST_RUN(format(FormatFloat(buf, sizeof(buf), -1.25, 2)) == "-1.25");
+  TEST_RUN(format(FormatFloat(buf, sizeof(buf), 3.14159, 3)) == "3.142");
+  TEST_RUN(format(FormatFloat(buf, sizeof(buf), 9.9996, 3)) == "10.000");
+  TEST_RUN(format(FormatFloat(buf, sizeof(buf), 123.0, 0)) == "123");
+  TEST_RUN(format(FormatFloat(buf, sizeof(buf), 1.5e20, 2)) == "1.50e+20");
+  TEST_RUN(format(FormatFloat(buf, sizeof(buf), -1.0 / 0.0)) == "-inf");
+  TEST_RUN(format(FormatFloat(buf, sizeof(buf), 0.0 / 0.0)) == "nan");
+  TEST_RUN(FormatFloat(buf, sizeof(buf), 1.0, 10).error() == ESP_ERR_INVALID_ARG);
+
+  {
+    DataBuf out;
+    AppendInt(out, 42);
+    out.push_back(',');
+    AppendFixed<int32_t, 1>(out, -15);
+    out.push_back(',');
+    AppendFloat(out, 0.5, 1);
+    TEST_RUN(std::string(out.begin(), out.end()) == "42,-1.5,0.5");
+  }
+
+  return ESP_OK;
+}
+
+esp_err_t _bench_ZWNumbers() {
+  static constexpr int kIterations = 2000;
+  [[maybe_unused]] volatile int32_t int_sink;
+  [[maybe_unused]] volatile double float_sink;
+  [[maybe_unused]] volatile size_t len_sink;
+  char buf[kMaxFloatChars];
+
+  BENCH_RUN("ParseInt<int32_t>", kIterations, int_sink = *ParseInt<int32_t>("-1234567"));
+  BENCH_RUN("strtol", kIterations, int_sink = strtol("-1234567", NULL, 10));
+  BENCH_RUN("atoi", kIterations, int_sink = atoi("-1234567"));
+  BENCH_RUN("ParseFloat<double>", kIterations, float_sink = *ParseFloat<double>("-1234.567"));
+  BENCH_RUN("strtod", kIterations, float_sink = strtod("-1234.567", NULL));
+  BENCH_RUN("FormatInt<int32_t>", kIterations, len_sink = *FormatInt(buf, sizeof(buf), -1234567));
+  BENCH_RUN("snprintf(%d)", kIterations, len_sink = snprintf(buf, sizeof(buf), "%d", -1234567));
+
+  return ESP_OK;
+}
+
+esp_err_t _test_ZWCodecs() {
+  auto as_str = [](const DataBuf& buf) { return std::string(buf.begin(), buf.end()); };
+  auto base64 = [&](std::string_view in, Base64Alphabet alphabet = Base64Alphabet::kStandard,
+                    bool pad = true) {
+    DataBuf out;
+    Base64Encode((const uint8_t*)in.data(), in.size(), out, alphabet, pad);
+    return as_str(out);
+  };
+  auto unbase64 = [&](std::string_view in, Base64Alphabet alphabet = Base64Alphabet::kStandard) {
+    DataBuf out;
+    return Base64Decode(in, out, alphabet) == ESP_OK ? as_str(out) : std::string("<error>");
+  };
+
+  // RFC 4648 test vectors
+  TEST_RUN(base64("") == "");
+  TEST_RUN(base64("f") == "Zg==");
+  TEST_RUN(base64("fo") == "Zm8=");
+  TEST_RUN(base64("foo") == "Zm9v");
+  TEST_RUN(base64("foob") == "Zm9vYg==");
+  TEST_RUN(base64("fooba") == "Zm9vYmE=");
+  TEST_RUN(base64("foobar") == "Zm9vYmFy");
+  TEST_RUN(base64("fooba", Base64Alphabet::kStandard, false) == "Zm9vYmE");
+  TEST_RUN(base64("\xfb\xff") == "+/8=");
+  TEST_RUN(base64("\xfb\xff", Base64Alphabet::kUrlSafe) == "-_8=");
+  TEST_RUN(Base64EncodedSize(5) == 8);
+  TEST_RUN(Base64EncodedSize(5, false) == 7);
+
+  TEST_RUN(unbase64("") == "");
+  TEST_RUN(unbase64("Zg==") == "f");
+  TEST_RUN(unbase64("Zm8=") == "fo");
+  TEST_RUN(unbase64("Zm9vYmFy") == "foobar");
+  TEST_RUN(unbase64("Zm9vYmE") == "fooba");
+  TEST_RUN(unbase64("-_8=", Base64Alphabet::kUrlSafe) == "\xfb\xff");
+  TEST_RUN(unbase64("-_8=") == "<error>");
+  TEST_RUN(unbase64("Zm9=v") == "<error>");
+  TEST_RUN(unbase64("Zm8") == "fo");
+  TEST_RUN(unbase64("Zm8==") == "<error>");
+  TEST_RUN(unbase64("QQ=====") == "<error>");
+  TEST_RUN(unbase64("QQ==QQ==") == "<error>");
+  TEST_RUN(unbase64("Z") == "<error>");
+  TEST_RUN(Base64DecodedSize("Zm9vYmE=") == 5);
+  {
+    uint8_t out[2];
+    TEST_RUN(Base64Decode("Zm9v", out, sizeof(out)).error() == ESP_ERR_INVALID_SIZE);
+  }
+  {
+    DataBuf buf;
+    buf.resize(strlen(buf.PrintTo("Zm9vYmE=")));
+    TEST_ASSERT(Base64DecodeInPlace(buf) == ESP_OK);
+    TEST_RUN(as_str(buf) == "fooba");
+  }
+
+  {
+    static constexpr char kInput[] = "The quick brown fox jumps over the lazy dog";
+    DataBuf encoded;
+    Base64Encoder encoder;
+    for (size_t i = 0; i < STRLEN(kInput); i += 5)
+      encoder.Update((const uint8_t*)kInput + i, std::min<size_t>(5, STRLEN(kInput) - i), encoded);
+    encoder.Finish(encoded);
+    TEST_RUN(as_str(encoded) == base64(kInput));
+
+    // Chunked, with line breaks
+    std::string pem = as_str(encoded).insert(20, "\r\n").insert(40, "\n");
+    DataBuf decoded;
+    Base64Decoder decoder;
+    for (size_t i = 0; i < pem.size(); i += 7) {
+      TEST_ASSERT(decoder.Update(std::string_view(pem).substr(i, 7), decoded) == ESP_OK);
+    }
+    TEST_RUN(decoder.Finish(decoded) == ESP_OK);
+    TEST_RUN(as_str(decoded) == kInput);
+
+    TEST_RUN(decoder.Update("Zm9v*", decoded) == ESP_ERR_INVALID_ARG);
+    decoder.Finish(decoded);
+    TEST_RUN(decoder.Update("Zg==Zg", decoded) == ESP_ERR_INVALID_ARG);
+    decoder.Finish(decoded);
+    TEST_RUN(decoder.Update("QQ=====", decoded) == ESP_ERR_INVALID_ARG);
+    decoder.Finish(decoded);
+    TEST_RUN(decoder.Update("QUI==", decoded) == ESP_ERR_INVALID_ARG);
+    decoder.Finish(decoded);
+    decoded.clear();
+    TEST_RUN(decoder.Update("QQ=", decoded) == ESP_OK && decoder.Update("=", decoded) == ESP_OK);
+    TEST_RUN(decoder.Finish(decoded) == ESP_OK && as_str(decoded) == "A");
+  }
+
+  {
+    static constexpr uint8_t kData[] = {0x00, 0x1f, 0xa0, 0xff};
+    DataBuf out;
+    HexEncode(kData, sizeof(kData), out);
+    TEST_RUN(as_str(out) == "001fa0ff");
+    out.clear();
+    HexEncode(kData, sizeof(kData), out, true);
+    TEST_RUN(as_str(out) == "001FA0FF");
+
+    TEST_ASSERT(HexDecodeInPlace(out) == ESP_OK);
+    TEST_RUN(out.size() == sizeof(kData) && memcmp(out.data(), kData, sizeof(kData)) == 0);
+
+    out.clear();
+    TEST_RUN(HexDecode("001fA0Ff", out) == ESP_OK);
+    TEST_RUN(out.size() == sizeof(kData) && memcmp(out.data(), kData, sizeof(kData)) == 0);
+    TEST_RUN(HexDecode("0g", out) == ESP_ERR_INVALID_ARG);
+    TEST_RUN(HexDecode("001", out) == ESP_ERR_INVALID_ARG);
+    TEST_RUN(out.size() == sizeof(kData));
+  }
+
+  return ESP_OK;
+}
+
+esp_err_t _bench_ZWCodecs() {
+  static constexpr int kIterations = 20;
+  static constexpr size_t kBlobSize = 4096;
+  DataBuf blob(kBlobSize);
+  for (size_t i = 0; i < kBlobSize; ++i) blob[i] = i * 131 + 7;
+  DataBuf text(HexEncodedSize(kBlobSize));
+  DataBuf data(kBlobSize);
+  [[maybe_unused]] volatile size_t len_sink;
+
+  // Typical ad-hoc byte-by-byte implementations
+  auto naive_hex_encode = [&] {
+    for (size_t i = 0; i < kBlobSize; ++i) {
+      text[i * 2] = "0123456789abcdef"[blob[i] >> 4];
+      text[i * 2 + 1] = "0123456789abcdef"[blob[i] & 0xF];
+    }
+  };
+  auto naive_hex_decode = [&] {
+    for (size_t i = 0; i < kBlobSize; ++i) data[i] = *ParseHexByte((const char*)&text[i * 2]);
+  };
+  static constexpr char kAlphabet[] =
+      "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  auto naive_base64_encode = [&] {
+    uint32_t acc = 0, bits = 0, out = 0;
+    for (size_t i = 0; i < kBlobSize; ++i) {
+      acc = (acc << 8) | blob[i];
+      for (bits += 8; bits >= 6; bits -= 6) text[out++] = kAlphabet[(acc >> (bits - 6)) & 0x3F];
+    }
+  };
+  auto naive_base64_decode = [&] {
+    uint32_t acc = 0, bits = 0, out = 0;
+    for (size_t i = 0; i < Base64EncodedSize(kBlobSize) && text[i] != '='; ++i) {
+      acc = (acc << 6) | (strchr(kAlphabet, text[i]) - kAlphabet);
+      if ((bits += 6) >= 8) data[out++] = acc >> (bits -= 8);
+    }
+  };
+
+  BENCH_RUN("HexEncode (4KB)", kIterations,
+            len_sink = *HexEncode(blob.data(), kBlobSize, (char*)text.data(), text.size()));
+  BENCH_RUN("Naive hex encode (4KB)", kIterations, naive_hex_encode());
+  BENCH_RUN("HexDecode (4KB)", kIterations,
+            len_sink = *HexDecode({(char*)text.data(), HexEncodedSize(kBlobSize)}, data.data(),
+                                  data.size()));
+  BENCH_RUN("Naive hex decode (4KB)", kIterations, naive_hex_decode());
+  BENCH_RUN("Base64Encode (4KB)", kIterations,
+            len_sink = *Base64Encode(blob.data(), kBlobSize, (char*)text.data(), text.size()));
+  BENCH_RUN("Naive base64 encode (4KB)", kIterations, naive_base64_encode());
+  BENCH_RUN("Base64Decode (4KB)", kIterations,
+            len_sink = *Base64Decode({(char*)text.data(), Base64EncodedSize(kBlobSize)},
+                                     data.data(), data.size()));
+  BENCH_RUN("Naive base64 decode (4KB)", kIterations, naive_base64_decode());
+
+  return ESP_OK;
+}
+
+esp_err_t _test_ZWChecksums() {
+  static constexpr char kCheck[] = "123456789";
+  TEST_RUN(Crc32::Compute(kCheck, 0) == 0);
+  TEST_RUN(Crc32::Compute(kCheck, STRLEN(kCheck)) == 0xCBF43926);
+  {
+    // Incremental updates at arbitrary alignment
+    DataBuf buf(1000);
+    for (size_t i = 0; i < buf.size(); ++i) buf[i] = i * 7;
+    uint32_t expected = Crc32::Compute(buf);
+    Crc32 crc;
+    for (size_t i = 0; i < buf.size(); i += 13)
+      crc.Update(buf.data() + i, std::min<size_t>(13, buf.size() - i));
+    TEST_RUN(crc.value() == expected);
+    crc.Reset();
+    TEST_RUN(crc.Update(kCheck, STRLEN(kCheck)).value() == 0xCBF43926);
+  }
+
+  static_assert(Fnv1a32("") == 0x811C9DC5);
+  TEST_RUN(Fnv1a32("a") == 0xE40C292C);
+  TEST_RUN(Fnv1a32("foobar") == 0xBF9CF968);
+
+  static_assert(XXHash32("") == 0x02CC5D05);
+  TEST_RUN(XXHash32("a") == 0x550D7456);
+  TEST_RUN(XXHash32("abc") == 0x32D153FF);
+  TEST_RUN(XXHash32("Nobody inspects the spammish repetition") == 0xE2293B2F);
+  TEST_RUN(XXHash32Bytes(kCheck, STRLEN(kCheck)) == XXHash32(kCheck));
+  // Seeded, the two-argument call must not pick the raw buffer overload
+  static_assert(XXHash32("abc", 7) == 0x57CFD434);
+  TEST_RUN(XXHash32Bytes("abc", 3, 7) == 0x57CFD434);
+  TEST_RUN(XXHash32("Nobody inspects the spammish repetition", 0x9E3779B1) == 0xC9E89E68);
+
+  return ESP_OK;
+}
+
+esp_err_t _bench_ZWChecksums() {
+  static constexpr int kIterations = 20;
+  static constexpr size_t kBlobSize = 4096;
+  DataBuf blob(kBlobSize);
+  for (size_t i = 0; i < kBlobSize; ++i) blob[i] = i * 131 + 7;
+  [[maybe_unused]] volatile uint32_t sink;
+
+  // Typical ad-hoc bit-wise implementation
+  auto naive_crc32 = [&] {
+    uint32_t crc = ~0U;
+    for (uint8_t b : blob) {
+      crc ^= b;
+      for (int k = 0; k < 8; ++k) crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+    }
+    return ~crc;
+  };
+
+  BENCH_RUN("Crc32 (4KB)", kIterations, sink = Crc32::Compute(blob));
+  BENCH_RUN("Naive bit-wise CRC32 (4KB)", kIterations, sink = naive_crc32());
+  BENCH_RUN("XXHash32 (4KB)", kIterations, sink = XXHash32(blob));
+  BENCH_RUN("Fnv1a32 (4KB)", kIterations, sink = Fnv1a32({(char*)blob.data(), blob.size()}));
+
+  return ESP_OK;
+}
+
+esp_err_t _test_ZWJsonTokenizer() {
+  {
+    JsonTokenizer<16> json;
+    TEST_ASSERT(
+        json.Parse(R"({"name": "test", "port": 8080, "on": true, "ids": [1, -2], "x": null})"));
+    TEST_RUN(json.size() == 13);
+    TEST_RUN(json[0].type == JsonToken::kObject);
+    TEST_RUN(json[0].members == 5);
+    TEST_RUN(json[0].next == 13);
+    TEST_RUN(IS_OK_AND_VALUE(json.Find(0, "name"), == 2));
+    TEST_RUN(IS_OK_AND_VALUE(json.GetString(2), == "test"));
+    TEST_RUN(IS_OK_AND_VALUE(json.GetInt<uint16_t>(*json.Find(0, "port")), == 8080));
+    TEST_RUN(IS_OK_AND_VALUE(json.GetBool(*json.Find(0, "on")), == true));
+    TEST_RUN(json.IsNull(*json.Find(0, "x")));
+    TEST_RUN(json.Find(0, "missing").error() == ESP_ERR_NOT_FOUND);
+
+    size_t ids = *json.Find(0, "ids");
+    TEST_RUN(json[ids].members == 2);
+    TEST_RUN(json.Text(ids) == "[1, -2]");
+    TEST_RUN(IS_OK_AND_VALUE(json.GetInt<int32_t>(*json.At(ids, 1)), == -2));
+    TEST_RUN(json.At(ids, 2).error() == ESP_ERR_NOT_FOUND);
+    TEST_RUN(json.GetInt<int32_t>(2).error() == ESP_ERR_INVALID_ARG);
+  }
+  {
+    JsonTokenizer<4> json;
+    TEST_RUN(IS_OK_AND_VALUE(json.Parse(" 1.5e-3 "), == 1));
+    TEST_RUN(json[0].type == JsonToken::kNumber);
+    TEST_RUN(json.GetInt<int32_t>(0).error() == ESP_ERR_INVALID_ARG);
+
+    TEST_RUN(json.Parse("[1, 2, 3, 4, 5]").error() == ESP_ERR_NO_MEM);
+    TEST_RUN(json.Parse("[1, 2,]").error() == ESP_ERR_INVALID_ARG);
+    TEST_RUN(json.error_pos() == 6);
+    TEST_RUN(json.Parse("{\"a\" 1}").error() == ESP_ERR_INVALID_ARG);
+    TEST_RUN(json.error_pos() == 5);
+    TEST_RUN(json.Parse("[01]").error() == ESP_ERR_INVALID_ARG);
+    TEST_RUN(json.Parse("[1] 2").error() == ESP_ERR_INVALID_ARG);
+    TEST_RUN(json.Parse("{\"a\": [1}").error() == ESP_ERR_INVALID_ARG);
+    TEST_RUN(json.Parse("{\"a\": \"b").error() == ESP_ERR_INVALID_SIZE);
+    TEST_RUN(json.Parse("").error() == ESP_ERR_INVALID_SIZE);
+    TEST_RUN(json.Parse(R"(["\ud800"])").error() == ESP_ERR_INVALID_ARG);
+  }
+  {
+    DataBuf buf;
+    buf.PrintTo(R"(["a\tb\"", "\u00e9\ud83d\ude00"])");
+    JsonTokenizer<4> json;
+    TEST_ASSERT(json.Parse(buf));
+    TEST_RUN(IS_OK_AND_VALUE(json.GetString(1), == "a\tb\""));
+    TEST_RUN(IS_OK_AND_VALUE(json.GetString(2), == "\xc3\xa9\xf0\x9f\x98\x80"));
+    // Decoding is idempotent
+    TEST_RUN(IS_OK_AND_VALUE(json.GetString(2), == "\xc3\xa9\xf0\x9f\x98\x80"));
+
+    // Read-only input cannot be decoded in place
+    TEST_ASSERT(json.Parse(R"(["a\tb"])"));
+    TEST_RUN(json.GetString(1).error() == ESP_ERR_NOT_SUPPORTED);
+  }
+
+  return ESP_OK;
+}
+
+esp_err_t _test_ZWTrace() {
+  DataBuf out;
+#ifdef ZW_TRACE_ENABLE
+  TraceReset();
+  {
+    ZW_TRACE_SCOPE("outer");
+    ZW_TRACE_COUNTER("queue", -3);
+    { ZW_TRACE_SCOPE("inner"); }
+  }
+  TraceDump(out);
+
+  static JsonTokenizer<64> json;
+  TEST_ASSERT(json.Parse(std::string_view((char*)out.data(), out.size())));
+  size_t events = *json.Find(0, "traceEvents");
+  TEST_RUN(json[events].members == 4);
+  TEST_RUN(IS_OK_AND_VALUE(json.GetString(*json.Find(*json.At(events, 0), "ph")), == "M"));
+  TEST_RUN(IS_OK_AND_VALUE(json.GetString(*json.Find(*json.At(events, 1), "name")), == "queue"));
+  TEST_RUN(IS_OK_AND_VALUE(json.GetString(*json.Find(*json.At(events, 1), "ph")), == "C"));
+  TEST_RUN(json.Text(*json.Find(*json.Find(*json.At(events, 1), "args"), "value")) == "-3");
+  TEST_RUN(IS_OK_AND_VALUE(json.GetString(*json.Find(*json.At(events, 2), "name")), == "inner"));
+  TEST_RUN(IS_OK_AND_VALUE(json.GetString(*json.Find(*json.At(events, 3), "name")), == "outer"));
+  TEST_RUN(IS_OK_AND_VALUE(json.GetString(*json.Find(*json.At(events, 3), "ph")), == "X"));
+  TEST_RUN(IS_OK_AND_VALUE(json.GetInt<uint32_t>(*json.Find(*json.At(events, 3), "ts")),
+                           <= *json.GetInt<uint32_t>(*json.Find(*json.At(events, 2), "ts"))));
+
+  // Names are escaped
+  TraceReset();
+  ZW_TRACE_COUNTER("say \"hi\"\\\n", 1);
+  out.clear();
+  TraceDump(out);
+  TEST_ASSERT(json.Parse(out));
+  events = *json.Find(0, "traceEvents");
+  TEST_RUN(IS_OK_AND_VALUE(json.GetString(*json.Find(*json.At(events, 1), "name")),
+                           == "say \"hi\"\\\n"));
+
+  // Ring buffer wraps around, keeping the most recent events
+  TraceReset();
+  for (int i = 0; i < ZW_TRACE_BUFFER_EVENTS * 2; ++i) ZW_TRACE_COUNTER("wrap", i);
+  out.clear();
+  TraceDump(out);
+  std::string_view text((char*)out.data(), out.size());
+  size_t count = 0;
+  for (size_t pos = 0; (pos = text.find("\"wrap\"", pos)) != text.npos; ++pos) ++count;
+  TEST_RUN(count >= ZW_TRACE_BUFFER_EVENTS - 1 && count <= ZW_TRACE_BUFFER_EVENTS);
+  TEST_RUN(text.find(StrCat("\"value\":", ZW_TRACE_BUFFER_EVENTS * 2 - 1, "}")) != text.npos);
+  TEST_RUN(text.find("\"value\":0}") == text.npos);
+  TEST_RUN(TraceDropped() == 0);
+
+  // Tasks beyond the slot count are dropped, unless finished tasks release theirs
+  struct TracedTask {
+    EventGroupHandle_t done;
+    bool release;
+  } traced = {xEventGroupCreate(), false};
+  auto traced_task = [](void* param) {
+    TracedTask* traced = (TracedTask*)param;
+    ZW_TRACE_COUNTER("task", 1);
+    if (traced->release) TraceReleaseRing();
+    xEventGroupSetBits(traced->done, BIT0);
+    vTaskDelete(NULL);
+  };
+  for (bool release : {false, true}) {
+    traced.release = release;
+    TraceReset();
+    for (int i = 0; i <= ZW_TRACE_MAX_TASKS; ++i) {
+      TEST_ASSERT(xTaskCreate(traced_task, "traced", 2048, &traced, tskIDLE_PRIORITY + 1,
+                              nullptr) == pdPASS);
+      TEST_ASSERT(xEventGroupWaitBits(traced.done, BIT0, pdTRUE, pdTRUE, pdMS_TO_TICKS(1000)) &
+                  BIT0);
+    }
+    TEST_RUN(TraceDropped() == (release ? 0 : 1));
+  }
+  vEventGroupDelete(traced.done);
+  TraceReset();
+  out.clear();
+#endif
+
+  // Disabled configuration, see trace_disabled.cpp
+  TraceDisabledDump(out);
+  TEST_RUN(std::string_view((char*)out.data(), out.size()) == "{\"traceEvents\":[]}");
+
+  return ESP_OK;
+}
+
+esp_err_t _bench_ZWTrace() {
+#ifdef ZW_TRACE_ENABLE
+  TraceReset();
+  BENCH_RUN("ZW_TRACE_SCOPE", 1000, { ZW_TRACE_SCOPE("bench"); });
+  BENCH_RUN("ZW_TRACE_COUNTER", 1000, ZW_TRACE_COUNTER("bench", bench_i));
+  TraceReset();
+#endif
+
+  return ESP_OK;
+}
+
+esp_err_t _test_ZWBinLog() {
+  BinLogRecord record;
+  char message[64];
+  while (BinLogPop(record)) continue;
+
+  ZW_BINLOGI(TAG, "value %d at %s, 0x%x", -5, "here", 0xABCDu);
+  TEST_ASSERT(BinLogPop(record));
+  TEST_RUN(record.level == ESP_LOG_INFO && record.tag == TAG);
+  BinLogFormat(record, message, sizeof(message));
+  TEST_RUN(strcmp(message, "value -5 at here, 0xabcd") == 0);
+  TEST_RUN(!BinLogPop(record));
+
+  uint32_t overflow = BinLogOverflow();
+  for (int i = 0; i < ZW_BINLOG_BUFFER_RECORDS + 3; ++i) ZW_BINLOGW(TAG, "#%d", i);
+  TEST_RUN(BinLogOverflow() == overflow + 3);
+  int count = 0;
+  for (; BinLogPop(record); ++count) {
+    BinLogFormat(record, message, sizeof(message));
+    TEST_ASSERT(strcmp(message, StrCat('#', count).c_str()) == 0);
+  }
+  TEST_RUN(count == ZW_BINLOG_BUFFER_RECORDS);
+
+  TEST_RUN(BinLogEnabledFailing() == ESP_ERR_INVALID_STATE);
+#ifndef NDEBUG
+  TEST_ASSERT(BinLogPop(record));
+  TEST_RUN(record.level == ESP_LOG_DEBUG);
+  BinLogFormat(record, message, sizeof(message));
+  TEST_RUN(strstr(message, "ESP Error") == message);
+  TEST_RUN(record.args[2] == ESP_ERR_INVALID_STATE);
+#endif
+
+  return ESP_OK;
+}
+
+esp_err_t _bench_ZWBinLog() {
+  BinLogRecord record;
+  char message[64];
+
+  BENCH_RUN("ZW_BINLOGI", 1000, {
+    ZW_BINLOGI(TAG, "Error (%s:%d) %d", __FILE__, __LINE__, bench_i);
+    BinLogPop(record);
+  });
+  BENCH_RUN("snprintf (same message)", 1000,
+            snprintf(message, sizeof(message), "Error (%s:%d) %d", __FILE__, __LINE__, bench_i));
+
+  return ESP_OK;
+}
+
+esp_err_t _test_ZWTimerWheel() {
+  using Wheel = TimerWheel<8, 4>;
+  static Wheel wheel(1000);
+  EventGroupHandle_t events = xEventGroupCreate();
+  TEST_ASSERT(events != nullptr);
+  AutoRelease events_releaser([&] { vEventGroupDelete(events); });
+
+  {
+    auto timer = wheel.Arm(3, events, BIT0);
+    TEST_ASSERT(timer);
+    TEST_RUN(timer->pending() && wheel.active() == 1);
+    TEST_RUN(IS_OK_AND_VALUE(wheel.NextWakeup(), == 3));
+    TEST_RUN(wheel.Advance(1002) == 0);
+    TEST_RUN(xEventGroupGetBits(events) == 0);
+    TEST_RUN(wheel.Advance(1003) == 1);
+    TEST_RUN(xEventGroupGetBits(events) == BIT0);
+    TEST_RUN(!timer->pending() && !timer->Cancel() && wheel.active() == 0);
+    TEST_RUN(wheel.NextWakeup().error() == ESP_ERR_NOT_FOUND);
+  }
+
+  // Cancelled by the handle going out of scope
+  xEventGroupClearBits(events, BIT0);
+  { TEST_ASSERT(wheel.Arm(1, events, BIT0)); }
+  TEST_RUN(wheel.active() == 0);
+  TEST_RUN(wheel.Advance(1010) == 0 && xEventGroupGetBits(events) == 0);
+
+  // Timers beyond a wheel revolution, callbacks, and rearming
+  {
+    static int fired;
+    fired = 0;
+    auto count = [](void* arg) { fired += (intptr_t)arg; };
+    auto far = wheel.Arm(9, count, (void*)100);
+    auto near = wheel.Arm(1, count, (void*)1);
+    auto idle = wheel.Arm(2, count, (void*)10);
+    TEST_ASSERT(far && near && idle);
+    TEST_RUN(wheel.Advance(1011) == 1 && fired == 1);
+    TEST_RUN(idle->Rearm(4));
+    TEST_RUN(wheel.Advance(1014) == 0 && fired == 1);
+    TEST_RUN(wheel.Advance(1015) == 1 && fired == 11);
+    TEST_RUN(!idle->Rearm(4));
+    TEST_RUN(wheel.Advance(1018) == 0 && fired == 11);
+    TEST_RUN(wheel.Advance(1100) == 1 && fired == 111);
+  }
+
+  // Pool exhaustion, and handles do not cancel reused timers
+  {
+    std::vector<Wheel::Timer> timers;
+    for (size_t i = 0; i < Wheel::capacity(); ++i) {
+      auto timer = wheel.Arm(i, events, BIT1);
+      TEST_ASSERT(timer);
+      timers.push_back(std::move(*timer));
+    }
+    TEST_RUN(wheel.Arm(1, events, BIT1).error() == ESP_ERR_NO_MEM);
+    TEST_RUN(wheel.Advance(wheel.now() + 1) == 2);
+    auto reused = wheel.Arm(5, events, BIT2);
+    TEST_ASSERT(reused);
+    TEST_RUN(!timers[0].Cancel() && !timers[1].Cancel());
+    TEST_RUN(reused->pending());
+    timers.clear();
+    TEST_RUN(wheel.active() == 1);
+    reused->Drop();
+    TEST_RUN(wheel.Advance(wheel.now() + 5) == 1);
+    TEST_RUN(xEventGroupGetBits(events) == (BIT1 | BIT2));
+  }
+
+  // Callbacks may arm more timers
+  {
+    static Wheel::Timer chained;
+    static Wheel::Callback chained_callback;
+    static int fired;
+    fired = 0;
+    // Lambdas cannot refer to themselves, go through a function pointer
+    chained_callback = [](void*) {
+      if (++fired < 3) chained = std::move(*wheel.Arm(1, chained_callback));
+    };
+    Wheel::Callback callback = chained_callback;
+    auto timer = wheel.Arm(1, callback);
+    TEST_ASSERT(timer);
+    for (int i = 0; i < 5; ++i) wheel.Advance(wheel.now() + 1);
+    TEST_RUN(fired == 3 && wheel.active() == 0);
+  }
+
+  // Many timers in one slot, expiring in batches, next to ones due a revolution later
+  {
+    static TimerWheel<32, 4> crowded;
+    static int fired;
+    fired = 0;
+    auto count = [](void*) { ++fired; };
+    std::vector<TimerWheel<32, 4>::Timer> timers;
+    for (int i = 0; i < 25; ++i) {
+      auto timer = crowded.Arm(i < 20 ? 2 : 6, count);
+      TEST_ASSERT(timer);
+      timers.push_back(std::move(*timer));
+    }
+    TEST_RUN(crowded.Advance(2) == 20 && fired == 20 && crowded.active() == 5);
+    TEST_RUN(crowded.Advance(6) == 5 && fired == 25 && crowded.active() == 0);
+  }
+
+  return ESP_OK;
+}
+
+esp_err_t _bench_ZWTimerWheel() {
+  static TimerWheel<256> wheel;
+  static TimerWheel<256>::Timer timers[256];
+  EventGroupHandle_t events = xEventGroupCreate();
+  AutoRelease events_releaser([&] { vEventGroupDelete(events); });
+
+  BENCH_RUN("TimerWheel arm + cancel", 1000, {
+    auto timer = wheel.Arm(bench_i % 200, events, BIT0);
+  });
+  for (size_t i = 0; i < 256; ++i) {
+    timers[i] = std::move(*wheel.Arm(i * 2654435761U % 1000, events, BIT0));
+  }
+  BENCH_RUN("TimerWheel rearm (256 active)", 1000, timers[bench_i % 256].Rearm(bench_i % 500 + 1));
+  BENCH_RUN("TimerWheel advance (256 active)", 1000, wheel.Advance(wheel.now() + 1));
+
+  return ESP_OK;
+}
+
+// Representative payloads for compression
+DataBuf _sample_json() {
+  DataBuf json;
+  StrAppend(json, "{\"device\":\"esp8266\",\"sensors\":[");
+  for (int i = 0; i < 40; ++i) {
+    StrAppend(json, i ? "," : "", "{\"id\":", i, ",\"name\":\"sensor-", i * 7 % 13,
+              "\",\"value\":", (i * 37 % 1000) / 10.0, ",\"unit\":\"C\",\"ok\":true}");
+  }
+  StrAppend(json, "]}");
+  return json;
+}
+
+DataBuf _sample_html() {
+  DataBuf html;
+  StrAppend(html, "<!DOCTYPE html><html><head><meta charset=\"utf-8\"><title>Status</title>",
+            "<link rel=\"stylesheet\" href=\"style.css\"></head><body><table class=\"list\">");
+  for (int i = 0; i < 40; ++i) {
+    StrAppend(html, "<tr class=\"", i % 2 ? "odd" : "even", "\"><td class=\"id\">", i,
+              "</td><td class=\"name\">Item ", i * 7 % 13, "</td><td><a href=\"/item?id=", i,
+              "\">Details</a></td></tr>\n");
+  }
+  StrAppend(html, "</table></body></html>");
+  return html;
+}
+
+esp_err_t _test_ZWCompression() {
+  using Encoder = LzEncoder<>;
+  using Decoder = LzDecoder<>;
+  static Encoder encoder;
+  static Decoder decoder;
+
+  auto round_trip = [&](const DataBuf& data, size_t chunk) {
+    DataBuf compressed, decompressed;
+    for (size_t pos = 0; pos < data.size(); pos += chunk) {
+      encoder.Update(data.data() + pos, std::min(chunk, data.size() - pos), compressed);
+    }
+    encoder.Finish(compressed);
+    for (size_t pos = 0; pos < compressed.size(); pos += chunk) {
+      size_t len = std::min(chunk, compressed.size() - pos);
+      if (decoder.Update(compressed.data() + pos, len, decompressed) != ESP_OK) return false;
+    }
+    return decoder.Finish() == ESP_OK && decompressed == data;
+  };
+
+  {
+    DataBuf out;
+    encoder.Finish(out);
+    TEST_RUN(out.empty());
+    const uint8_t kRun[] = "aaaaaaaa";
+    encoder.Update(kRun, 8, out);
+    encoder.Finish(out);
+    // Literal 'a', then a back-reference of distance 1 and length 7
+    TEST_RUN(out == DataBuf({0xB0, 0x80, 0x05}));
+  }
+
+  DataBuf json = _sample_json();
+  DataBuf html = _sample_html();
+  DataBuf noise(3000);
+  for (size_t i = 0; i < noise.size(); ++i) noise[i] = (i * 2654435761U) >> 13;
+  DataBuf zeros(5000, 0);
+  for (const DataBuf* data : {&json, &html, &noise, &zeros}) {
+    TEST_RUN(round_trip(*data, data->size()));
+    TEST_RUN(round_trip(*data, 1));
+    TEST_RUN(round_trip(*data, 100));
+  }
+  TEST_RUN(round_trip(DataBuf{'x'}, 1));
+
+  {
+    // Output does not depend on chunking, and actually compresses
+    DataBuf one_shot, chunked;
+    LzCompress(json.data(), json.size(), one_shot);
+    for (uint8_t c : json) encoder.Update(&c, 1, chunked);
+    encoder.Finish(chunked);
+    TEST_RUN(one_shot == chunked);
+    TEST_RUN(one_shot.size() < json.size() / 2);
+    // Incompressible data expands by at most 1/8
+    DataBuf expanded;
+    LzCompress(noise.data(), noise.size(), expanded);
+    TEST_RUN(expanded.size() <= noise.size() * 9 / 8 + 1);
+    // Decoding in small chunks does not reallocate the output every time
+    DataBuf decoded;
+    size_t reallocs = 0;
+    for (size_t pos = 0; pos < expanded.size(); pos += 16) {
+      const uint8_t* before = decoded.data();
+      TEST_ASSERT(decoder.Update(expanded.data() + pos, std::min<size_t>(16, expanded.size() - pos),
+                                 decoded) == ESP_OK);
+      reallocs += decoded.data() != before;
+    }
+    TEST_RUN(decoder.Finish() == ESP_OK && decoded == noise);
+    TEST_RUN(reallocs < 20);
+
+    // Other parameters
+    DataBuf small, restored;
+    LzCompress<8, 4>(html.data(), html.size(), small);
+    TEST_RUN((LzDecompress<8, 4>(small.data(), small.size(), restored) == ESP_OK));
+    TEST_RUN(restored == html);
+
+    // Corrupted and truncated streams
+    DataBuf out;
+    TEST_RUN(LzDecompress(one_shot.data(), one_shot.size() - 2, out) == ESP_ERR_INVALID_SIZE);
+    const uint8_t kBadDistance[] = {0x00, 0x40, 0x00};
+    out.clear();
+    TEST_RUN(LzDecompress(kBadDistance, sizeof(kBadDistance), out) == ESP_ERR_INVALID_ARG);
+  }
+
+  return ESP_OK;
+}
+
+template <unsigned WindowBits>
+esp_err_t _bench_Lz(const char* name, const DataBuf& data) {
+  static LzEncoder<WindowBits> encoder;
+  static LzDecoder<WindowBits> decoder;
+  DataBuf compressed, decompressed;
+  encoder.Update(data, compressed);
+  encoder.Finish(compressed);
+  ESP_LOGI(TAG, "[Bench] %s, window %d: %d -> %d bytes (%d%%)", name, 1 << WindowBits,
+           (int)data.size(), (int)compressed.size(), (int)(compressed.size() * 100 / data.size()));
+
+  std::string label = StrCat("Lz", WindowBits, " compress ", name);
+  BENCH_RUN(label.c_str(), 10, {
+    compressed.clear();
+    encoder.Update(data, compressed);
+    encoder.Finish(compressed);
+  });
+  label = StrCat("Lz", WindowBits, " decompress ", name);
+  BENCH_RUN(label.c_str(), 10, {
+    decompressed.clear();
+    decoder.Update(compressed, decompressed);
+    decoder.Finish();
+  });
+  TEST_ASSERT(decompressed == data);
+
+  return ESP_OK;
+}
+
+esp_err_t _bench_ZWCompression() {
+  DataBuf json = _sample_json();
+  DataBuf html = _sample_html();
+  if (_bench_Lz<8>("JSON", json) != ESP_OK) return ESP_FAIL;
+  if (_bench_Lz<10>("JSON", json) != ESP_OK) return ESP_FAIL;
+  if (_bench_Lz<8>("HTML", html) != ESP_OK) return ESP_FAIL;
+  if (_bench_Lz<10>("HTML", html) != ESP_OK) return ESP_FAIL;
+
+  return ESP_OK;
+}
+
+esp_err_t _test_ZWTlv() {
+  auto as_view = [](const DataBuf& buf) {
+    return std::string_view((const char*)buf.data(), buf.size());
+  };
+
+  {
+    DataBuf buf;
+    TlvWriter(buf).Put(1, "hi").PutInt(2, 300u).PutInt(3, -1).PutInt(4, 0).PutBool(5, true);
+    TEST_RUN(buf == DataBuf({1, 2, 'h', 'i', 2, 2, 0xAC, 0x02, 3, 1, 1, 4, 0, 5, 1, 1}));
+
+    TlvReader reader(buf);
+    auto field = reader.Next();
+    TEST_RUN(field && field->tag == 1 && field->value == "hi");
+    TEST_RUN(field->value.data() == (const char*)buf.data() + 2);  // No copy
+    TEST_RUN(IS_OK_AND_VALUE(reader.Next()->AsInt<uint16_t>(), == 300));
+    TEST_RUN(IS_OK_AND_VALUE(reader.Next()->AsInt<int8_t>(), == -1));
+    TEST_RUN(IS_OK_AND_VALUE(reader.Next()->AsInt<int32_t>(), == 0));
+    TEST_RUN(IS_OK_AND_VALUE(reader.Next()->AsBool(), == true));
+    TEST_RUN(reader.done() && reader.Next().error() == ESP_ERR_NOT_FOUND);
+
+    TEST_RUN(TlvReader(buf).Find(2)->AsInt<uint8_t>().error() == ESP_ERR_INVALID_SIZE);
+    TEST_RUN(TlvReader(buf).Find(9).error() == ESP_ERR_NOT_FOUND);
+  }
+  {
+    // Full integer ranges, large tags
+    DataBuf buf;
+    TlvWriter(buf)
+        .PutInt(0xFFFFFFFF, INT64_MIN)
+        .PutInt(128, INT64_MAX)
+        .PutInt(7, UINT64_MAX)
+        .PutInt(8, INT32_MIN);
+    TlvReader reader(buf);
+    auto field = reader.Next();
+    TEST_RUN(field && field->tag == 0xFFFFFFFF);
+    TEST_RUN(IS_OK_AND_VALUE(field->AsInt<int64_t>(), == INT64_MIN));
+    TEST_RUN(IS_OK_AND_VALUE(reader.Next()->AsInt<int64_t>(), == INT64_MAX));
+    TEST_RUN(IS_OK_AND_VALUE(reader.Next()->AsInt<uint64_t>(), == UINT64_MAX));
+    field = reader.Next();
+    TEST_RUN(IS_OK_AND_VALUE(field->AsInt<int32_t>(), == INT32_MIN));
+    TEST_RUN(field->AsInt<int16_t>().error() == ESP_ERR_INVALID_SIZE);
+  }
+  {
+    // Nested records, including lengths beyond one byte
+    DataBuf buf;
+    TlvWriter writer(buf);
+    writer.PutInt(1, 42);
+    size_t nested = writer.BeginNested(2);
+    writer.Put(1, std::string(200, 'x')).PutInt(2, 7);
+    writer.EndNested(nested);
+    writer.Put(3, "end");
+
+    TlvReader reader(buf);
+    TEST_RUN(reader.Find(3)->value == "end");
+    TEST_ASSERT(reader.Next());
+    auto field = reader.Next();
+    TEST_RUN(field && field->tag == 2 && field->size() == 206);
+    TlvReader inner = field->AsTlv();
+    TEST_RUN(inner.Next()->value == std::string(200, 'x'));
+    TEST_RUN(IS_OK_AND_VALUE(inner.Next()->AsInt<int>(), == 7));
+    TEST_RUN(inner.done());
+    TEST_RUN(reader.Next()->value == "end");
+  }
+  {
+    // Unknown fields are skipped by readers looking for known tags
+    DataBuf buf;
+    TlvWriter(buf).Put(100, "future").PutInt(1, 5);
+    TEST_RUN(IS_OK_AND_VALUE(TlvReader(buf).Find(1)->AsInt<int>(), == 5));
+
+    // Truncated and malformed data
+    std::string_view data = as_view(buf);
+    for (size_t len = 1; len < data.size(); ++len) {
+      if (len == 8) continue;  // Between fields
+      TlvReader reader(data.substr(0, len));
+      auto first = reader.Next();
+      TEST_ASSERT(len < 8 ? !first : (first && !reader.Next()));
+    }
+    TEST_RUN(TlvReader("\xFF\xFF\xFF\xFF\xFF\x01\x00").Next().error() == ESP_ERR_INVALID_SIZE);
+    TEST_RUN((TlvField{1, "\x80"}.AsInt<int>().error() == ESP_ERR_INVALID_SIZE));
+    TEST_RUN((TlvField{1, "\x01\x01"}.AsInt<int>().error() == ESP_ERR_INVALID_SIZE));
+  }
+
+  return ESP_OK;
+}
+
+// Typical device settings, and text round-trip for comparison
+struct BenchSettings {
+  std::string ssid, password, hostname;
+  uint16_t port;
+  uint32_t ip;
+  bool dhcp;
+  int32_t utc_offset;
+};
+
+struct BenchSettingsView {
+  std::string_view ssid, password, hostname;
+  uint16_t port;
+  uint32_t ip;
+  bool dhcp;
+  int32_t utc_offset;
+};
+
+enum BenchSettingsTag : uint32_t { kSsid = 1, kPassword, kHostname, kPort, kIp, kDhcp, kUtcOffset };
+
+esp_err_t _bench_ZWTlv() {
+  const BenchSettings settings = {
+      "HomeNetwork-5G", "correct horse battery", "esp-livingroom", 8080, 0xC0A80164, false,
+      -28800};
+
+  auto text_encode = [&](DataBuf& buf) {
+    buf.PrintTo("ssid=%s\npassword=%s\nhostname=%s\nport=%u\nip=%u\ndhcp=%d\nutc_offset=%d\n",
+                settings.ssid.c_str(), settings.password.c_str(), settings.hostname.c_str(),
+                settings.port, settings.ip, settings.dhcp, settings.utc_offset);
+    buf.resize(strlen((char*)buf.data()));
+  };
+  auto text_decode = [](const DataBuf& buf, BenchSettings& out) {
+    std::string_view text((const char*)buf.data(), buf.size());
+    while (!text.empty()) {
+      size_t eol = text.find('\n');
+      std::string_view line = text.substr(0, eol);
+      text.remove_prefix(eol == text.npos ? text.size() : eol + 1);
+      size_t eq = line.find('=');
+      if (eq == line.npos) return ESP_ERR_INVALID_ARG;
+      std::string key(line.substr(0, eq)), value(line.substr(eq + 1));
+      if (key == "ssid") out.ssid = value;
+      if (key == "password") out.password = value;
+      if (key == "hostname") out.hostname = value;
+      if (key == "port") out.port = strtoul(value.c_str(), nullptr, 10);
+      if (key == "ip") out.ip = strtoul(value.c_str(), nullptr, 10);
+      if (key == "dhcp") out.dhcp = strtol(value.c_str(), nullptr, 10);
+      if (key == "utc_offset") out.utc_offset = strtol(value.c_str(), nullptr, 10);
+    }
+    return ESP_OK;
+  };
+
+  auto tlv_encode = [&](DataBuf& buf) {
+    TlvWriter(buf)
+        .Put(kSsid, settings.ssid)
+        .Put(kPassword, settings.password)
+        .Put(kHostname, settings.hostname)
+        .PutInt(kPort, settings.port)
+        .PutInt(kIp, settings.ip)
+        .PutBool(kDhcp, settings.dhcp)
+        .PutInt(kUtcOffset, settings.utc_offset);
+  };
+  auto tlv_decode = [](const DataBuf& buf, BenchSettingsView& out) -> esp_err_t {
+    TlvReader reader(buf);
+    while (!reader.done()) {
+      ASSIGN_OR_RETURN(TlvField field, reader.Next());
+      switch (field.tag) {
+        case kSsid:
+          out.ssid = field.value;
+          break;
+        case kPassword:
+          out.password = field.value;
+          break;
+        case kHostname:
+          out.hostname = field.value;
+          break;
+        case kPort: {
+          ASSIGN_OR_RETURN(out.port, field.AsInt<uint16_t>());
+        } break;
+        case kIp: {
+          ASSIGN_OR_RETURN(out.ip, field.AsInt<uint32_t>());
+        } break;
+        case kDhcp: {
+          ASSIGN_OR_RETURN(out.dhcp, field.AsBool());
+        } break;
+        case kUtcOffset: {
+          ASSIGN_OR_RETURN(out.utc_offset, field.AsInt<int32_t>());
+        } break;
+        default:  // Unknown field, skipped
+          break;
+      }
+    }
+    return ESP_OK;
+  };
+
+  DataBuf text, tlv;
+  BenchSettings text_out;
+  BenchSettingsView tlv_out;
+  text_encode(text);
+  tlv_encode(tlv);
+  TEST_ASSERT(text_decode(text, text_out) == ESP_OK);
+  TEST_ASSERT(tlv_decode(tlv, tlv_out) == ESP_OK);
+  TEST_ASSERT(text_out.ssid == settings.ssid && text_out.utc_offset == settings.utc_offset);
+  TEST_ASSERT(tlv_out.hostname == settings.hostname && tlv_out.ip == settings.ip &&
+              tlv_out.dhcp == settings.dhcp && tlv_out.utc_offset == settings.utc_offset);
+  ESP_LOGI(TAG, "[Bench] Settings size: text %d bytes, TLV %d bytes", (int)text.size(),
+           (int)tlv.size());
+
+  BENCH_RUN("Settings text round-trip", 1000, {
+    text.clear();
+    text_encode(text);
+    text_decode(text, text_out);
+  });
+  BENCH_RUN("Settings TLV round-trip", 1000, {
+    tlv.clear();
+    tlv_encode(tlv);
+    tlv_decode(tlv, tlv_out);
+  });
+
   return ESP_OK;
 }
 
@@ -438,9 +1624,28 @@ esp_err_t _run() {
   if (_test_ZWAutoRelease() != ESP_OK) return ESP_FAIL;
   if (_test_ZWDataOrError() != ESP_OK) return ESP_FAIL;
   if (_test_ZWParsers() != ESP_OK) return ESP_FAIL;
+  if (_test_ZWFormatters() != ESP_OK) return ESP_FAIL;
+  if (_test_ZWCodecs() != ESP_OK) return ESP_FAIL;
+  if (_test_ZWChecksums() != ESP_OK) return ESP_FAIL;
+  if (_test_ZWJsonTokenizer() != ESP_OK) return ESP_FAIL;
   if (_test_ZWMacros_EventWait() != ESP_OK) return ESP_FAIL;
   if (_test_ZWMacros_Semaphore() != ESP_OK) return ESP_FAIL;
   if (_test_DataBuf() != ESP_OK) return ESP_FAIL;
+  if (_test_ZWTrace() != ESP_OK) return ESP_FAIL;
+  if (_test_ZWBinLog() != ESP_OK) return ESP_FAIL;
+  if (_test_ZWTimerWheel() != ESP_OK) return ESP_FAIL;
+  if (_test_ZWCompression() != ESP_OK) return ESP_FAIL;
+  if (_test_ZWTlv() != ESP_OK) return ESP_FAIL;
+
+  if (_bench_ZWStrings() != ESP_OK) return ESP_FAIL;
+  if (_bench_ZWNumbers() != ESP_OK) return ESP_FAIL;
+  if (_bench_ZWCodecs() != ESP_OK) return ESP_FAIL;
+  if (_bench_ZWChecksums() != ESP_OK) return ESP_FAIL;
+  if (_bench_ZWTrace() != ESP_OK) return ESP_FAIL;
+  if (_bench_ZWBinLog() != ESP_OK) return ESP_FAIL;
+  if (_bench_ZWTimerWheel() != ESP_OK) return ESP_FAIL;
+  if (_bench_ZWCompression() != ESP_OK) return ESP_FAIL;
+  if (_bench_ZWTlv() != ESP_OK) return ESP_FAIL;
 
   return ESP_OK;
 }
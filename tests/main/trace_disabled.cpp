@@ -0,0 +1,24 @@
+// Tracing compiled out, linked into the (traced) test program
+
+#undef ZW_TRACE_ENABLE
+
+#include "esp_err.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+
+#include "FreeRTOS.h"
+#include "freertos/event_groups.h"
+#include "freertos/semphr.h"
+
+#include "ZWUtils.hpp"
+
+namespace zw::esp8266::utils::testing {
+
+void TraceDisabledDump(DataBuf& out) {
+  ZW_TRACE_SCOPE("disabled");
+  ZW_TRACE_COUNTER("disabled", 1);
+  TraceReleaseRing();
+  TraceDump(out);
+}
+
+}  // namespace zw::esp8266::utils::testing